@@ -0,0 +1,162 @@
+// 多蛇对战的基准测试：一次操作为一条活着的蛇走一步，只计 step() 的耗时
+// 每条蛇大多直走，偶尔随机转向，避开下一步就会撞上的格子；死去的蛇每步都重新放置
+// arena/tiled 从 1 个线程测到硬件线程数：各线程数跑相同的步数，终局哈希不同时报错并计为失败
+#include "Bench.h"
+#include "Arena.h"
+#include "TiledArena.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct ArenaConfig {
+    int cols;
+    int rows;
+    int snakes;
+    int foods;
+    bool large;
+};
+
+const ArenaConfig ARENA_CONFIGS[] = {
+    {256, 256, 256, 256, false},
+    {1024, 1024, 1024, 4096, false},
+    // 食物很多，蛇很快长长：对比上一项看蛇身变长（以及频繁补食物）后每步耗时的变化
+    {1024, 1024, 1024, 262144, false},
+    {2048, 2048, 4096, 16384, true},
+};
+
+struct TiledConfig {
+    int cols;
+    int rows;
+    int snakes;
+    int foods;
+    bool large;
+};
+
+const TiledConfig TILED_CONFIGS[] = {
+    {4096, 4096, 16384, 65536, false},
+    {10000, 10000, 50000, 400000, true},
+};
+
+template <class World>
+bool blocked(const World& arena, Position p) {
+    return p.x < 0 || p.y < 0 || p.x >= arena.cols() || p.y >= arena.rows() || arena.ownerAt(p) >= 0;
+}
+
+template <class World>
+void chooseActions(const World& arena, Rng& rng, std::vector<Direction>& actions) {
+    for (int i = 0; i < arena.snakeCount(); ++i) {
+        if (!arena.isAlive(i)) continue;
+        Direction d = arena.direction(i);
+        if (rng.bounded(8) == 0 || blocked(arena, advance(arena.head(i), d))) {
+            Direction turn = static_cast<Direction>(rng.bounded(4));
+            if (turn != opposite(d) && !blocked(arena, advance(arena.head(i), turn))) {
+                d = turn;
+            }
+        }
+        actions[i] = d;
+    }
+}
+
+void benchArena(BenchContext& context, const ArenaConfig& config) {
+    std::string name = "arena/step/" + std::to_string(config.cols) + "x" + std::to_string(config.rows) + "/x" +
+                       std::to_string(config.snakes) + "/food" + std::to_string(config.foods);
+    if (!context.enabled(name)) return;
+
+    Arena arena(config.cols, config.rows, config.snakes, config.foods, 1);
+    Rng rng(2);
+    std::vector<Direction> actions(config.snakes, RIGHT);
+    std::vector<StepResult> results(config.snakes);
+    double seconds = 0;
+    long long moves = 0;
+    long long ticks = 0;
+    while (seconds < context.minSeconds) {
+        for (int i = 0; i < arena.snakeCount(); ++i) {
+            if (!arena.isAlive(i)) arena.spawn(i);
+        }
+        chooseActions(arena, rng, actions);
+        moves += arena.aliveCount();
+        auto start = std::chrono::steady_clock::now();
+        arena.step(actions.data(), results.data());
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        ++ticks;
+    }
+    long long totalLength = 0;
+    for (int i = 0; i < arena.snakeCount(); ++i) totalLength += arena.length(i);
+    context.report(name, moves / seconds);
+    std::printf("    %lld ticks, %.1f us/tick, %d alive, avg length %.1f\n", ticks, seconds * 1e6 / ticks,
+                arena.aliveCount(),
+                arena.aliveCount() > 0 ? static_cast<double>(totalLength) / arena.aliveCount() : 0.0);
+}
+
+// 跑 ticks 步（为 0 时跑满 minSeconds），返回实际步数；hash 为终局哈希
+long long runTiled(BenchContext& context, const std::string& name, const TiledConfig& config, int threads,
+                   long long ticks, uint64_t& hash) {
+    TiledArena arena(config.cols, config.rows, config.snakes, config.foods, 1, threads);
+    Rng rng(2);
+    std::vector<Direction> actions(config.snakes, RIGHT);
+    std::vector<StepResult> results(config.snakes);
+    double seconds = 0;
+    long long moves = 0;
+    long long done = 0;
+    while (ticks > 0 ? done < ticks : seconds < context.minSeconds) {
+        for (int i = 0; i < arena.snakeCount(); ++i) {
+            if (!arena.isAlive(i)) arena.spawn(i);
+        }
+        chooseActions(arena, rng, actions);
+        moves += arena.aliveCount();
+        auto start = std::chrono::steady_clock::now();
+        arena.step(actions.data(), results.data());
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        ++done;
+    }
+    context.report(name, moves / seconds);
+    hash = arena.stateHash();
+    std::printf("    %lld ticks, %.1f us/tick, %d tiles, state hash %016llx\n", done, seconds * 1e6 / done,
+                arena.tileCount(), static_cast<unsigned long long>(hash));
+    return done;
+}
+
+void benchTiled(BenchContext& context, const TiledConfig& config) {
+    std::string prefix = "arena/tiled/" + std::to_string(config.cols) + "x" + std::to_string(config.rows) + "/x" +
+                         std::to_string(config.snakes) + "/t";
+    int hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> threadCounts;
+    for (int t = 1; t < hardware; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(hardware);
+    long long ticks = 0;
+    uint64_t firstHash = 0;
+    int firstThreads = 0;
+    for (int threads : threadCounts) {
+        std::string name = prefix + std::to_string(threads);
+        if (!context.enabled(name)) continue;
+        uint64_t hash = 0;
+        ticks = runTiled(context, name, config, threads, ticks, hash);
+        if (firstThreads == 0) {
+            firstHash = hash;
+            firstThreads = threads;
+        } else if (hash != firstHash) {
+            std::fprintf(stderr, "ERROR: %s ended with state hash %016llx, but %d thread(s) gave %016llx\n",
+                         name.c_str(), static_cast<unsigned long long>(hash), firstThreads,
+                         static_cast<unsigned long long>(firstHash));
+            ++context.failures;
+        }
+    }
+}
+
+}
+
+void runArenaBenchmarks(BenchContext& context) {
+    for (const ArenaConfig& config : ARENA_CONFIGS) {
+        if (config.large && context.quick) continue;
+        benchArena(context, config);
+    }
+    for (const TiledConfig& config : TILED_CONFIGS) {
+        if (config.large && context.quick) continue;
+        benchTiled(context, config);
+    }
+}
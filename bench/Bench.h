@@ -0,0 +1,70 @@
+#ifndef SNAKE_BENCH_H
+#define SNAKE_BENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 一项测量结果：每秒完成的操作数（操作的含义由各项测试自己定义，如一步、一帧、一次放置食物）
+struct BenchResult {
+    std::string name;
+    double opsPerSec;
+    double nsPerOp;
+};
+
+class BenchContext {
+public:
+    BenchContext() : quick(false), minSeconds(0.25), failures(0) {}
+
+    // 名字包含 filter 中的任一子串才运行，filter 为空时全部运行
+    bool enabled(const std::string& name) const;
+
+    // 反复调用 body(n) 并把 n 翻倍，直到单次耗时超过 minSeconds；body 完成 n 次操作
+    template <class Body>
+    void measure(const std::string& name, Body body) {
+        if (!enabled(name)) return;
+        int64_t n = 1;
+        for (;;) {
+            auto start = std::chrono::steady_clock::now();
+            body(n);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (seconds >= minSeconds || n >= (int64_t(1) << 40)) {
+                report(name, static_cast<double>(n) / seconds);
+                return;
+            }
+            // 按已测得的速度估算下一轮的次数，避免在慢的测试上翻倍太多次
+            double scale = seconds > 0 ? minSeconds * 1.2 / seconds : 16.0;
+            n = static_cast<int64_t>(n * (scale < 2 ? 2 : (scale > 16 ? 16 : scale)));
+        }
+    }
+    void report(const std::string& name, double opsPerSec);
+
+    // 跳过 4096x4096 等耗时、占内存较多的配置
+    bool quick;
+    double minSeconds;
+    std::vector<std::string> filters;
+    std::vector<BenchResult> results;
+    // 测量时顺带做的校验（如各线程数的终局哈希应相同）失败的次数，非 0 时 SnakeBench 返回 1
+    int failures;
+};
+
+// 阻止编译器把只读不用的结果优化掉
+inline void benchKeep(int64_t value) {
+    static volatile int64_t sink;
+    sink = value;
+    (void)sink;
+}
+
+void runEngineBenchmarks(BenchContext& context);
+void runRngBenchmarks(BenchContext& context);
+void runPolicyBenchmarks(BenchContext& context);
+void runEnvBenchmarks(BenchContext& context);
+void runObsBenchmarks(BenchContext& context);
+void runArenaBenchmarks(BenchContext& context);
+void runNetBenchmarks(BenchContext& context);
+#ifdef SNAKE_BENCH_RENDER
+void runRenderBenchmarks(BenchContext& context);
+#endif
+
+#endif // SNAKE_BENCH_H
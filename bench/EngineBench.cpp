@@ -0,0 +1,174 @@
+// 规则引擎的基准测试：单局推进、放置食物、碰撞检测、批量环境
+#include "Bench.h"
+#include "SnakeEngine.h"
+#include "VecEngine.h"
+#include "HamiltonPolicy.h"
+#include "Rng.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+struct BoardSize {
+    int cols;
+    int rows;
+    bool large;
+};
+
+const BoardSize BOARD_SIZES[] = {
+    {32, 24, false},
+    {256, 256, false},
+    {1024, 1024, true},
+    {4096, 4096, true},
+};
+
+// 蛇身占棋盘的百分比；0 表示开局的三格
+const int FILL_PERCENTS[] = {0, 10, 50, 90, 99};
+
+std::string sizeName(int cols, int rows) {
+    return std::to_string(cols) + "x" + std::to_string(rows);
+}
+
+std::string fillName(int percent) {
+    return percent == 0 ? "len3" : "fill" + std::to_string(percent);
+}
+
+// 占据回路前 length 格的蛇，蛇头在第 length - 1 格
+std::vector<Position> snakeOnCycle(const std::vector<int>& order, int cols, int length) {
+    std::vector<Position> body(length);
+    for (int i = 0; i < length; ++i) {
+        int cell = order[length - 1 - i];
+        body[i] = {cell % cols, cell / cols};
+    }
+    return body;
+}
+
+int fillLength(int cells, int percent) {
+    if (percent == 0) return 3;
+    int length = static_cast<int>(static_cast<int64_t>(cells) * percent / 100);
+    return length < 3 ? 3 : length;
+}
+
+void benchStep(BenchContext& context, const BoardSize& size) {
+    std::string prefix = "engine/step/" + sizeName(size.cols, size.rows) + "/";
+    bool any = false;
+    for (int percent : FILL_PERCENTS) any = any || context.enabled(prefix + fillName(percent));
+    if (!any) return;
+
+    int cells = size.cols * size.rows;
+    std::shared_ptr<const HamiltonCycle> cycle = HamiltonCycle::forBoard(size.cols, size.rows);
+    const std::vector<int>& order = cycle->order();
+    SnakeEngine engine(size.cols, size.rows, 1);
+
+    for (int percent : FILL_PERCENTS) {
+        if (!context.enabled(prefix + fillName(percent))) continue;
+        std::vector<Position> body = snakeOnCycle(order, size.cols, fillLength(cells, percent));
+        Direction startDir = directionTo(body[1], body[0]);
+        unsigned int seed = 1;
+        int sinceReset = 0;
+        engine.reset(seed++, body, startDir);
+        // 吃到食物会变长，每走 cells 步重开一次让长度保持在设定值附近（重开的开销摊到每步约一次内存写）
+        context.measure(prefix + fillName(percent), [&](int64_t n) {
+            for (int64_t i = 0; i < n; ++i) {
+                Position head = engine.body().front();
+                StepResult result = engine.step(cycle->forward(head.y * size.cols + head.x));
+                if (++sinceReset >= cells || result == STEP_WON || result == STEP_DIED) {
+                    engine.reset(seed++, body, startDir);
+                    sinceReset = 0;
+                }
+            }
+            benchKeep(engine.body().size());
+        });
+    }
+}
+
+// 放置食物：在给定占用率下随机取一个空格、占用后再释放（即 generateFood() 加上蛇尾回收的开销）
+void benchFood(BenchContext& context, const BoardSize& size) {
+    for (int percent : FILL_PERCENTS) {
+        std::string name = "engine/food/" + sizeName(size.cols, size.rows) + "/" + fillName(percent);
+        if (!context.enabled(name)) continue;
+        Rng rng(1);
+        FreeCellSet freeCells(size.cols, size.rows);
+        int length = fillLength(size.cols * size.rows, percent);
+        for (int i = 0; i < length; ++i) {
+            Position cell = freeCells.at(rng.bounded(freeCells.size()));
+            freeCells.occupy(cell.x, cell.y);
+        }
+        context.measure(name, [&](int64_t n) {
+            int64_t sum = 0;
+            for (int64_t i = 0; i < n; ++i) {
+                Position cell = freeCells.at(rng.bounded(freeCells.size()));
+                freeCells.occupy(cell.x, cell.y);
+                freeCells.release(cell.x, cell.y);
+                sum += cell.x;
+            }
+            benchKeep(sum);
+        });
+    }
+}
+
+// 碰撞检测：在给定占用率的位图上查询随机格子（含越界判断）
+void benchCollision(BenchContext& context, const BoardSize& size) {
+    const int PROBE_COUNT = 4096;
+    for (int percent : FILL_PERCENTS) {
+        std::string name = "engine/collision/" + sizeName(size.cols, size.rows) + "/" + fillName(percent);
+        if (!context.enabled(name)) continue;
+        Rng rng(1);
+        OccupancyGrid grid(size.cols, size.rows);
+        int cells = size.cols * size.rows;
+        int length = fillLength(cells, percent);
+        for (int i = 0; i < length; ++i) {
+            int cell = rng.bounded(cells);
+            grid.set(cell % size.cols, cell / size.cols);
+        }
+        // 探测点比棋盘四周各多出一格，覆盖撞墙的情况
+        std::vector<Position> probes(PROBE_COUNT);
+        for (Position& p : probes) {
+            p.x = static_cast<int>(rng.bounded(size.cols + 2)) - 1;
+            p.y = static_cast<int>(rng.bounded(size.rows + 2)) - 1;
+        }
+        context.measure(name, [&](int64_t n) {
+            int64_t hits = 0;
+            for (int64_t i = 0; i < n; ++i) {
+                const Position& p = probes[i & (PROBE_COUNT - 1)];
+                hits += !grid.inside(p.x, p.y) || grid.test(p.x, p.y);
+            }
+            benchKeep(hits);
+        });
+    }
+}
+
+// 批量环境：每个棋盘都沿回路方向走（开局那一行须为偶数行，与初始方向一致），死亡后自动重开
+// 一次操作为一个棋盘推进一步
+void benchVec(BenchContext& context, int count, int cols, int rows) {
+    std::string name = "vec/step/" + sizeName(cols, rows) + "/x" + std::to_string(count);
+    if (!context.enabled(name)) return;
+    std::shared_ptr<const HamiltonCycle> cycle = HamiltonCycle::forBoard(cols, rows);
+    VecEngine envs(count, cols, rows, 1);
+    std::vector<Direction> actions(count);
+    std::vector<StepResult> results(count);
+    context.measure(name, [&](int64_t n) {
+        int64_t steps = (n + count - 1) / count;
+        for (int64_t s = 0; s < steps; ++s) {
+            for (int i = 0; i < count; ++i) {
+                Position head = envs.head(i);
+                actions[i] = cycle->forward(head.y * cols + head.x);
+            }
+            envs.step(actions.data(), results.data());
+        }
+        benchKeep(envs.episodes(0));
+    });
+}
+
+}
+
+void runEngineBenchmarks(BenchContext& context) {
+    for (const BoardSize& size : BOARD_SIZES) {
+        if (size.large && context.quick) continue;
+        benchStep(context, size);
+        benchFood(context, size);
+        benchCollision(context, size);
+    }
+    benchVec(context, 1024, 32, 24);
+    benchVec(context, 4096, 16, 16);
+}
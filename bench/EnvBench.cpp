@@ -0,0 +1,83 @@
+// C 接口训练环境的基准测试：一次操作为一个棋盘推进一步（含观测、奖励、结束标志的写入）
+// 动作事先随机生成，模拟训练初期频繁死亡重开的情况；同样的动作直接喂给 VecEngine 作对照，
+// 两者之差即为写观测的开销
+#include "Bench.h"
+#include "Rng.h"
+#include "VecEngine.h"
+#include "snake_env.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 动作表的长度（步数），循环使用
+const int ACTION_STEPS = 64;
+
+// 按 SNAKE_ENV_ALIGNMENT 对齐的缓冲区
+template <class T>
+struct AlignedBuffer {
+    explicit AlignedBuffer(size_t count) : storage(count * sizeof(T) + SNAKE_ENV_ALIGNMENT) {}
+    T* data() {
+        uintptr_t p = reinterpret_cast<uintptr_t>(storage.data());
+        p = (p + SNAKE_ENV_ALIGNMENT - 1) / SNAKE_ENV_ALIGNMENT * SNAKE_ENV_ALIGNMENT;
+        return reinterpret_cast<T*>(p);
+    }
+    std::vector<uint8_t> storage;
+};
+
+std::vector<int32_t> randomActions(int count) {
+    Rng rng(1);
+    std::vector<int32_t> actions(static_cast<size_t>(count) * ACTION_STEPS);
+    for (int32_t& a : actions) a = static_cast<int32_t>(rng.bounded(4));
+    return actions;
+}
+
+void benchEnv(BenchContext& context, int count, int cols, int rows) {
+    std::string suffix = std::to_string(cols) + "x" + std::to_string(rows) + "/x" + std::to_string(count);
+    std::vector<int32_t> actions = randomActions(count);
+
+    std::string name = "env/step/" + suffix;
+    if (context.enabled(name)) {
+        AlignedBuffer<uint8_t> observations(static_cast<size_t>(count) * snake_env_observation_bytes(cols, rows));
+        AlignedBuffer<float> rewards(count);
+        AlignedBuffer<uint8_t> dones(count);
+        SnakeEnvConfig config = {sizeof(SnakeEnvConfig), count, cols, rows, observations.data(), rewards.data(),
+                                 dones.data()};
+        SnakeEnv* env = snake_env_create(&config);
+        if (!env) return;
+        snake_env_reset(env, 1);
+        long long episodes = 0;
+        context.measure(name, [&](int64_t n) {
+            int64_t steps = (n + count - 1) / count;
+            for (int64_t s = 0; s < steps; ++s) {
+                snake_env_step(env, &actions[static_cast<size_t>(s % ACTION_STEPS) * count]);
+                episodes += dones.data()[0];
+            }
+            benchKeep(episodes);
+        });
+        snake_env_close(env);
+    }
+
+    name = "env/vec-baseline/" + suffix;
+    if (context.enabled(name)) {
+        VecEngine envs(count, cols, rows, 1);
+        std::vector<Direction> directions(actions.size());
+        for (size_t k = 0; k < actions.size(); ++k) directions[k] = static_cast<Direction>(actions[k]);
+        std::vector<StepResult> results(count);
+        context.measure(name, [&](int64_t n) {
+            int64_t steps = (n + count - 1) / count;
+            for (int64_t s = 0; s < steps; ++s) {
+                envs.step(&directions[static_cast<size_t>(s % ACTION_STEPS) * count], results.data());
+            }
+            benchKeep(envs.episodes(0));
+        });
+    }
+}
+
+}
+
+void runEnvBenchmarks(BenchContext& context) {
+    benchEnv(context, 1024, 32, 24);
+    benchEnv(context, 4096, 16, 16);
+}
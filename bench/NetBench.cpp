@@ -0,0 +1,95 @@
+// 联机快照的基准测试：服务器每步对确认到上一步的客户端编码一次增量、客户端应用一次；另测完整快照的编码
+// 一次操作为编码（或应用）一个快照，只计这部分的耗时；收发包的开销用 SnakeServer --bots 测
+#include "Bench.h"
+#include "NetProtocol.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct NetConfig {
+    int cols;
+    int rows;
+    int snakes;
+    int foods;
+};
+
+const NetConfig NET_CONFIGS[] = {
+    {64, 64, 64, 64},
+    {256, 256, 64, 1024},
+};
+
+// 每条蛇大多直走，偶尔随机转向；死去的蛇每步都重新放置
+void chooseActions(Arena& arena, Rng& rng, std::vector<Direction>& actions) {
+    for (int i = 0; i < arena.snakeCount(); ++i) {
+        if (!arena.isAlive(i)) arena.spawn(i);
+        actions[i] = rng.bounded(8) == 0 ? static_cast<Direction>(rng.bounded(4)) : arena.direction(i);
+    }
+}
+
+void benchNet(BenchContext& context, const NetConfig& config) {
+    std::string suffix = "/" + std::to_string(config.cols) + "x" + std::to_string(config.rows) + "/x" +
+                         std::to_string(config.snakes);
+    const std::string deltaName = "net/encode-delta" + suffix;
+    const std::string applyName = "net/apply-delta" + suffix;
+    const std::string fullName = "net/encode-full" + suffix;
+    if (!context.enabled(deltaName) && !context.enabled(applyName) && !context.enabled(fullName)) return;
+
+    Arena arena(config.cols, config.rows, config.snakes, config.foods, 1);
+    SnapshotHistory history;
+    history.start(arena);
+    NetMirror mirror;
+    mirror.setup(config.cols, config.rows, config.snakes);
+    std::vector<uint8_t> packet;
+    history.encode(arena, -1, packet);
+    mirror.apply(packet.data(), static_cast<int>(packet.size()));
+
+    Rng rng(2);
+    std::vector<Direction> actions(config.snakes, RIGHT);
+    std::vector<StepResult> results(config.snakes);
+    double encodeSeconds = 0;
+    double applySeconds = 0;
+    long long ticks = 0;
+    long long bytes = 0;
+    while (encodeSeconds + applySeconds < context.minSeconds) {
+        chooseActions(arena, rng, actions);
+        arena.step(actions.data(), results.data());
+        history.record(arena, results.data());
+
+        auto start = std::chrono::steady_clock::now();
+        history.encode(arena, mirror.tick(), packet);
+        auto encoded = std::chrono::steady_clock::now();
+        mirror.apply(packet.data(), static_cast<int>(packet.size()));
+        auto applied = std::chrono::steady_clock::now();
+        encodeSeconds += std::chrono::duration<double>(encoded - start).count();
+        applySeconds += std::chrono::duration<double>(applied - encoded).count();
+        bytes += static_cast<long long>(packet.size());
+        ++ticks;
+    }
+    if (context.enabled(deltaName)) context.report(deltaName, ticks / encodeSeconds);
+    if (context.enabled(applyName)) context.report(applyName, ticks / applySeconds);
+    std::printf("    %lld ticks, %.1f bytes per delta, mirror tick %lld\n", ticks,
+                static_cast<double>(bytes) / ticks, mirror.tick());
+
+    context.measure(fullName, [&](int64_t n) {
+        int64_t total = 0;
+        for (int64_t i = 0; i < n; ++i) {
+            history.encode(arena, -1, packet);
+            total += static_cast<int64_t>(packet.size());
+        }
+        benchKeep(total);
+    });
+    if (context.enabled(fullName)) {
+        std::printf("    %d bytes per full snapshot\n", static_cast<int>(packet.size()));
+    }
+}
+
+}
+
+void runNetBenchmarks(BenchContext& context) {
+    for (const NetConfig& config : NET_CONFIGS) {
+        benchNet(context, config);
+    }
+}
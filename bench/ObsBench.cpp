@@ -0,0 +1,132 @@
+// 观测编码的基准测试：一次操作为编码一个棋盘
+// 棋盘先沿哈密顿回路走一段，蛇长参差不齐；naive 为逐节遍历蛇身写 uint8 平面的做法，作对照
+#include "Bench.h"
+#include "HamiltonPolicy.h"
+#include "ObsEncoder.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct ObsBoard {
+    int count;
+    int cols;
+    int rows;
+    bool large;
+};
+
+const ObsBoard OBS_BOARDS[] = {
+    {1024, 32, 24, false},
+    {64, 256, 256, true},
+};
+
+const char* formatName(ObsFormat format) {
+    switch (format) {
+        case OBS_BITS: return "bits";
+        case OBS_U8: return "u8";
+        default: return "f32";
+    }
+}
+
+// 沿回路走 steps 步，让各棋盘吃到不同数量的食物
+void warmUp(VecEngine& envs, int steps) {
+    std::shared_ptr<const HamiltonCycle> cycle = HamiltonCycle::forBoard(envs.cols(), envs.rows());
+    std::vector<Direction> actions(envs.count());
+    std::vector<StepResult> results(envs.count());
+    for (int s = 0; s < steps; ++s) {
+        for (int i = 0; i < envs.count(); ++i) {
+            Position head = envs.head(i);
+            actions[i] = cycle->forward(head.y * envs.cols() + head.x);
+        }
+        envs.step(actions.data(), results.data());
+    }
+}
+
+std::string naiveName(const std::string& suffix) {
+    return "obs/naive/u8/full/" + suffix;
+}
+
+std::string encoderName(ObsFormat format, int radius, const std::string& suffix, int isa) {
+    return std::string("obs/") + formatName(format) + "/" +
+           (radius > 0 ? "crop" + std::to_string(radius) : std::string("full")) + "/" + suffix + "/" +
+           ObsEncoder::isaName(static_cast<ObsIsa>(isa));
+}
+
+void benchNaive(BenchContext& context, const VecEngine& envs, const std::string& suffix) {
+    std::string name = naiveName(suffix);
+    if (!context.enabled(name)) return;
+    const int cells = envs.cols() * envs.rows();
+    std::vector<unsigned char> out(static_cast<size_t>(envs.count()) * 4 * cells);
+    context.measure(name, [&](int64_t n) {
+        int64_t rounds = (n + envs.count() - 1) / envs.count();
+        for (int64_t r = 0; r < rounds; ++r) {
+            for (int i = 0; i < envs.count(); ++i) {
+                unsigned char* board = &out[static_cast<size_t>(i) * 4 * cells];
+                std::memset(board, 0, 4 * cells);
+                for (int k = 0; k < envs.length(i); ++k) {
+                    Position p = envs.segment(i, k);
+                    board[p.y * envs.cols() + p.x] = 1;
+                }
+                Position head = envs.head(i);
+                Position food = envs.food(i);
+                board[cells + head.y * envs.cols() + head.x] = 1;
+                board[2 * cells + food.y * envs.cols() + food.x] = 1;
+            }
+        }
+        benchKeep(out[0]);
+    });
+}
+
+void benchEncoder(BenchContext& context, const VecEngine& envs, const std::string& suffix, ObsFormat format,
+                  int radius) {
+    for (int isa = OBS_ISA_SCALAR; isa <= ObsEncoder::bestIsa(); ++isa) {
+        std::string name = encoderName(format, radius, suffix, isa);
+        if (!context.enabled(name)) continue;
+        ObsEncoder encoder(envs.cols(), envs.rows(), format, radius);
+        encoder.useIsa(static_cast<ObsIsa>(isa));
+        std::vector<uint64_t> out((envs.count() * encoder.bytesPerBoard() + 7) / 8);
+        context.measure(name, [&](int64_t n) {
+            int64_t rounds = (n + envs.count() - 1) / envs.count();
+            for (int64_t r = 0; r < rounds; ++r) {
+                encoder.encode(envs, out.data());
+            }
+            benchKeep(static_cast<int64_t>(out[0]));
+        });
+    }
+}
+
+const ObsFormat OBS_FORMATS[] = {OBS_BITS, OBS_U8, OBS_F32};
+const int OBS_RADII[] = {0, 7};
+
+// 预热棋盘耗时较长，没有选中任何一项时跳过
+bool anyEnabled(const BenchContext& context, const std::string& suffix) {
+    if (context.enabled(naiveName(suffix))) return true;
+    for (ObsFormat format : OBS_FORMATS) {
+        for (int radius : OBS_RADII) {
+            for (int isa = OBS_ISA_SCALAR; isa <= ObsEncoder::bestIsa(); ++isa) {
+                if (context.enabled(encoderName(format, radius, suffix, isa))) return true;
+            }
+        }
+    }
+    return false;
+}
+
+}
+
+void runObsBenchmarks(BenchContext& context) {
+    for (const ObsBoard& board : OBS_BOARDS) {
+        if (board.large && context.quick) continue;
+        std::string suffix = std::to_string(board.cols) + "x" + std::to_string(board.rows) + "/x" +
+                             std::to_string(board.count);
+        if (!anyEnabled(context, suffix)) continue;
+        VecEngine envs(board.count, board.cols, board.rows, 1);
+        warmUp(envs, board.cols * board.rows);
+        benchNaive(context, envs, suffix);
+        for (ObsFormat format : OBS_FORMATS) {
+            for (int radius : OBS_RADII) {
+                benchEncoder(context, envs, suffix, format, radius);
+            }
+        }
+    }
+}
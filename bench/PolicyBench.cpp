@@ -0,0 +1,71 @@
+// 自动驾驶策略的基准测试：一次操作为一次 decide()，只计策略本身的耗时（不含 step()）
+// 每项连续跑 minSeconds 的决策时间，局中死亡或填满棋盘后换种子重开
+// 逐次计时本身约有几十纳秒的开销，缓存命中时的数字以此为下限
+#include "Bench.h"
+#include "AStarPolicy.h"
+#include "Policy.h"
+#include <memory>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+struct PolicyBoard {
+    int cols;
+    int rows;
+    bool large;
+};
+
+const PolicyBoard POLICY_BOARDS[] = {
+    {32, 24, false},
+    {128, 128, false},
+    {512, 512, false},
+    {1024, 1024, true},
+};
+
+void benchPolicy(BenchContext& context, const std::string& policyName, const PolicyBoard& board) {
+    std::string name = "policy/" + policyName + "/" + std::to_string(board.cols) + "x" + std::to_string(board.rows);
+    if (!context.enabled(name)) return;
+
+    SnakeEngine engine(board.cols, board.rows, 1);
+    std::unique_ptr<Policy> policy = createPolicy(policyName);
+    unsigned int seed = 1;
+    double seconds = 0;
+    long long ticks = 0;
+    long long games = 0;
+    long long wins = 0;
+    long long totalLength = 0;
+    while (seconds < context.minSeconds) {
+        auto start = std::chrono::steady_clock::now();
+        Direction action = policy->decide(engine);
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        ++ticks;
+        StepResult result = engine.step(action);
+        if (result == STEP_DIED || result == STEP_WON) {
+            ++games;
+            wins += result == STEP_WON;
+            totalLength += engine.body().size();
+            engine.reset(++seed);
+            policy->reset();
+        }
+    }
+    context.report(name, ticks / seconds);
+    std::printf("    %lld games ended, %lld won, avg final length %.1f, current length %d\n", games, wins,
+                games > 0 ? static_cast<double>(totalLength) / games : 0.0, engine.body().size());
+    if (const AStarPolicy* astar = dynamic_cast<const AStarPolicy*>(policy.get())) {
+        std::printf("    %.3f plans/tick, %.1f cells expanded/plan\n",
+                    static_cast<double>(astar->plans()) / astar->decisions(),
+                    astar->plans() > 0 ? static_cast<double>(astar->expanded()) / astar->plans() : 0.0);
+    }
+}
+
+}
+
+void runPolicyBenchmarks(BenchContext& context) {
+    for (const PolicyBoard& board : POLICY_BOARDS) {
+        if (board.large && context.quick) continue;
+        benchPolicy(context, "astar", board);
+        benchPolicy(context, "hamilton", board);
+    }
+}
@@ -0,0 +1,175 @@
+// 绘制路径的基准测试：用 SDL 软件渲染器画到内存中的表面，不需要窗口和显卡
+// 一次操作为一帧；对比逐节 SDL_RenderCopyEx、整批 draw()、增量 drawIncremental() 和只画视口的 drawView()
+#include "Bench.h"
+#include "SnakeRenderer.h"
+#include "SnakeEngine.h"
+#include "HamiltonPolicy.h"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int BOARD_CELLS = 512;
+const int BENCH_CELL_SIZE = 4;
+const int SNAKE_LENGTHS[] = {1000, 10000, 50000};
+
+struct RenderTarget {
+    SDL_Surface* surface;
+    SDL_Renderer* renderer;
+};
+
+bool createTarget(RenderTarget& target) {
+    const int size = BOARD_CELLS * BENCH_CELL_SIZE;
+    target.surface = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (target.surface == nullptr) {
+        std::cerr << "Surface could not be created! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    target.renderer = SDL_CreateSoftwareRenderer(target.surface);
+    if (target.renderer == nullptr) {
+        std::cerr << "Software renderer could not be created! SDL Error: " << SDL_GetError() << std::endl;
+        SDL_FreeSurface(target.surface);
+        return false;
+    }
+    return true;
+}
+
+void destroyTarget(RenderTarget& target) {
+    SDL_DestroyRenderer(target.renderer);
+    SDL_FreeSurface(target.surface);
+}
+
+// 沿回路摆好 length 节的蛇，蛇头在第 length - 1 格
+SnakeBody snakeOnCycle(const std::vector<int>& order, int length) {
+    SnakeBody snake(static_cast<int>(order.size()));
+    for (int i = 0; i < length; ++i) {
+        snake.pushFront({order[i] % BOARD_CELLS, order[i] / BOARD_CELLS});
+    }
+    return snake;
+}
+
+// 改版前的画法：每节单独一次 SDL_RenderCopyEx
+void benchLegacy(BenchContext& context, const RenderTarget& target, const SnakeBody& snake, const std::string& name) {
+    SDL_Texture* sprite = SDL_CreateTexture(target.renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                            BENCH_CELL_SIZE, BENCH_CELL_SIZE);
+    std::vector<Uint32> pixels(BENCH_CELL_SIZE * BENCH_CELL_SIZE, 0xff00c000);
+    SDL_UpdateTexture(sprite, nullptr, pixels.data(), BENCH_CELL_SIZE * sizeof(Uint32));
+    context.measure(name, [&](int64_t n) {
+        for (int64_t frame = 0; frame < n; ++frame) {
+            SDL_SetRenderDrawColor(target.renderer, 0, 0, 0, 255);
+            SDL_RenderClear(target.renderer);
+            for (int i = 0; i < snake.size(); ++i) {
+                SDL_Rect rect = {snake[i].x * BENCH_CELL_SIZE, snake[i].y * BENCH_CELL_SIZE, BENCH_CELL_SIZE,
+                                 BENCH_CELL_SIZE};
+                SDL_RenderCopyEx(target.renderer, sprite, nullptr, &rect, 90.0 * (i & 3), nullptr, SDL_FLIP_NONE);
+            }
+            SDL_RenderPresent(target.renderer);
+        }
+    });
+    SDL_DestroyTexture(sprite);
+}
+
+void benchBatched(BenchContext& context, const RenderTarget& target, SnakeRenderer& snakeRenderer,
+                  const SnakeBody& snake, const std::string& name) {
+    Direction headDir = directionTo(snake[1], snake[0]);
+    context.measure(name, [&](int64_t n) {
+        for (int64_t frame = 0; frame < n; ++frame) {
+            SDL_SetRenderDrawColor(target.renderer, 0, 0, 0, 255);
+            SDL_RenderClear(target.renderer);
+            snakeRenderer.draw(target.renderer, snake, headDir, {0, 0}, BENCH_CELL_SIZE, 0, 0);
+            SDL_RenderPresent(target.renderer);
+        }
+    });
+}
+
+// 每帧蛇沿回路前进一格，按游戏里的方式标记变动的格子
+void benchIncremental(BenchContext& context, const RenderTarget& target, SnakeRenderer& snakeRenderer,
+                      const std::vector<int>& order, int length, const std::string& name) {
+    const int size = BOARD_CELLS * BENCH_CELL_SIZE;
+    if (!snakeRenderer.enableIncremental(target.renderer, size, size)) {
+        std::cerr << "Render targets unsupported, skipping " << name << std::endl;
+        return;
+    }
+    SnakeBody snake = snakeOnCycle(order, length);
+    int next = length % static_cast<int>(order.size());
+    Position food = {0, 0};
+    snakeRenderer.invalidate();
+    snakeRenderer.drawIncremental(target.renderer, snake, directionTo(snake[1], snake[0]), food, BENCH_CELL_SIZE);
+    context.measure(name, [&](int64_t n) {
+        for (int64_t frame = 0; frame < n; ++frame) {
+            Position oldHead = snake.front();
+            Position oldTail = snake.back();
+            snake.popBack();
+            snake.pushFront({order[next] % BOARD_CELLS, order[next] / BOARD_CELLS});
+            next = (next + 1) % static_cast<int>(order.size());
+            snakeRenderer.markDirty(oldHead);
+            snakeRenderer.markDirty(oldTail);
+            snakeRenderer.markDirty(snake.front());
+            snakeRenderer.markDirty(snake.back());
+            snakeRenderer.drawIncremental(target.renderer, snake, directionTo(snake[1], snake[0]), food,
+                                          BENCH_CELL_SIZE);
+            SDL_RenderPresent(target.renderer);
+        }
+    });
+}
+
+// 大棋盘模式：窗口大小的视口（32x24 格，每格 20 像素）跟着蛇头，耗时应与蛇长无关
+void benchView(BenchContext& context, const RenderTarget& target, SnakeRenderer& snakeRenderer,
+               const std::vector<int>& order, int length, const std::string& name) {
+    std::vector<Position> body(length);
+    for (int i = 0; i < length; ++i) {
+        body[i] = {order[length - 1 - i] % BOARD_CELLS, order[length - 1 - i] / BOARD_CELLS};
+    }
+    SnakeEngine engine(BOARD_CELLS, BOARD_CELLS, 1);
+    engine.reset(1, body, directionTo(body[1], body[0]));
+    Position head = engine.body().front();
+    SDL_Rect view = {std::max(0, head.x - 16), std::max(0, head.y - 12), 32, 24};
+    context.measure(name, [&](int64_t n) {
+        for (int64_t frame = 0; frame < n; ++frame) {
+            SDL_SetRenderDrawColor(target.renderer, 0, 0, 0, 255);
+            SDL_RenderClear(target.renderer);
+            snakeRenderer.drawView(target.renderer, engine.body(), engine.direction(), engine.food(),
+                                   engine.occupancy(), engine.slots(), view, 20);
+            SDL_RenderPresent(target.renderer);
+        }
+    });
+}
+
+}
+
+void runRenderBenchmarks(BenchContext& context) {
+    RenderTarget target;
+    if (!createTarget(target)) return;
+    SnakeRenderer snakeRenderer;
+    if (!snakeRenderer.buildAtlas(target.renderer, nullptr, nullptr, nullptr)) {
+        std::cerr << "Unable to build atlas, skipping render benchmarks" << std::endl;
+        destroyTarget(target);
+        return;
+    }
+
+    std::shared_ptr<const HamiltonCycle> cycle = HamiltonCycle::forBoard(BOARD_CELLS, BOARD_CELLS);
+    const std::vector<int>& order = cycle->order();
+    for (int length : SNAKE_LENGTHS) {
+        std::string suffix = std::to_string(BOARD_CELLS) + "x" + std::to_string(BOARD_CELLS) + "/len" +
+                             std::to_string(length);
+        SnakeBody snake = snakeOnCycle(order, length);
+        if (context.enabled("render/legacy/" + suffix)) {
+            benchLegacy(context, target, snake, "render/legacy/" + suffix);
+        }
+        if (context.enabled("render/batched/" + suffix)) {
+            benchBatched(context, target, snakeRenderer, snake, "render/batched/" + suffix);
+        }
+        if (context.enabled("render/incremental/" + suffix)) {
+            benchIncremental(context, target, snakeRenderer, order, length, "render/incremental/" + suffix);
+        }
+        if (context.enabled("render/view/" + suffix)) {
+            benchView(context, target, snakeRenderer, order, length, "render/view/" + suffix);
+        }
+    }
+
+    snakeRenderer.release();
+    destroyTarget(target);
+}
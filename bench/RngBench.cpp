@@ -0,0 +1,68 @@
+// 随机数的基准测试：C 的 rand()、std::mt19937 与 Rng（xoshiro256**），
+// 以及在 768 格（32x24 棋盘）内取随机格子的取模写法与无偏的 bounded()
+#include "Bench.h"
+#include "Rng.h"
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+const uint32_t CELL_COUNT = 32 * 24;
+
+}
+
+void runRngBenchmarks(BenchContext& context) {
+    context.measure("rng/rand", [](int64_t n) {
+        int64_t sum = 0;
+        for (int64_t i = 0; i < n; ++i) sum += std::rand();
+        benchKeep(sum);
+    });
+    std::mt19937 mt(1);
+    context.measure("rng/mt19937", [&mt](int64_t n) {
+        int64_t sum = 0;
+        for (int64_t i = 0; i < n; ++i) sum += mt();
+        benchKeep(sum);
+    });
+    Rng rng(1);
+    context.measure("rng/xoshiro256ss", [&rng](int64_t n) {
+        uint64_t sum = 0;
+        for (int64_t i = 0; i < n; ++i) sum += rng.next();
+        benchKeep(static_cast<int64_t>(sum));
+    });
+
+    // 取模有偏差，列出来只为对比速度
+    context.measure("rng/rand_mod", [](int64_t n) {
+        int64_t sum = 0;
+        for (int64_t i = 0; i < n; ++i) sum += std::rand() % CELL_COUNT;
+        benchKeep(sum);
+    });
+    context.measure("rng/mt19937_mod", [&mt](int64_t n) {
+        int64_t sum = 0;
+        for (int64_t i = 0; i < n; ++i) sum += mt() % CELL_COUNT;
+        benchKeep(sum);
+    });
+    context.measure("rng/xoshiro256ss_bounded", [&rng](int64_t n) {
+        int64_t sum = 0;
+        for (int64_t i = 0; i < n; ++i) sum += rng.bounded(CELL_COUNT);
+        benchKeep(sum);
+    });
+
+    // 开局的代价：批量环境每局都要重新播种
+    context.measure("rng/mt19937_seed", [&mt](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) mt.seed(static_cast<unsigned int>(i));
+        benchKeep(mt());
+    });
+    context.measure("rng/xoshiro256ss_seed", [&rng](int64_t n) {
+        uint64_t sum = 0;
+        for (int64_t i = 0; i < n; ++i) {
+            rng.seed(static_cast<uint64_t>(i));
+            sum += rng.state(0);
+        }
+        benchKeep(static_cast<int64_t>(sum));
+    });
+    context.measure("rng/xoshiro256ss_split", [&rng](int64_t n) {
+        uint64_t sum = 0;
+        for (int64_t i = 0; i < n; ++i) sum += rng.split().next();
+        benchKeep(static_cast<int64_t>(sum));
+    });
+}
@@ -0,0 +1,142 @@
+// 热点函数的基准测试
+// 用法：SnakeBench [--quick] [--filter 子串]... [--min-time 秒]
+//                  [--json 输出.json] [--baseline 基线.json [--tolerance 0.1]]
+// 指定 --baseline 时逐项与基线比较，任一项慢于基线超过 tolerance 则返回 1
+#include "Bench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+
+bool BenchContext::enabled(const std::string& name) const {
+    if (filters.empty()) return true;
+    for (const std::string& filter : filters) {
+        if (name.find(filter) != std::string::npos) return true;
+    }
+    return false;
+}
+
+void BenchContext::report(const std::string& name, double opsPerSec) {
+    BenchResult result = {name, opsPerSec, 1e9 / opsPerSec};
+    results.push_back(result);
+    std::printf("%-44s %14.0f ops/s %12.1f ns/op\n", name.c_str(), result.opsPerSec, result.nsPerOp);
+    std::fflush(stdout);
+}
+
+static bool writeJson(const std::string& path, const std::vector<BenchResult>& results) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Unable to write " << path << std::endl;
+        return false;
+    }
+    file << "{\"benchmarks\":[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        char line[256];
+        std::snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ops_per_sec\":%.3f,\"ns_per_op\":%.3f}%s\n",
+                      results[i].name.c_str(), results[i].opsPerSec, results[i].nsPerOp,
+                      i + 1 < results.size() ? "," : "");
+        file << line;
+    }
+    file << "]}\n";
+    return true;
+}
+
+// 只认本程序自己写出的格式：依次取每个 "name" 和它后面的 "ops_per_sec"
+static bool readJson(const std::string& path, std::map<std::string, double>& opsByName) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Unable to read " << path << std::endl;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string text = buffer.str();
+    const std::string nameKey = "\"name\":\"";
+    const std::string opsKey = "\"ops_per_sec\":";
+    size_t pos = 0;
+    while ((pos = text.find(nameKey, pos)) != std::string::npos) {
+        size_t begin = pos + nameKey.size();
+        size_t end = text.find('"', begin);
+        size_t ops = text.find(opsKey, end);
+        if (end == std::string::npos || ops == std::string::npos) break;
+        opsByName[text.substr(begin, end - begin)] = std::strtod(text.c_str() + ops + opsKey.size(), nullptr);
+        pos = ops;
+    }
+    return true;
+}
+
+static int compareBaseline(const std::vector<BenchResult>& results, const std::map<std::string, double>& baseline,
+                           double tolerance) {
+    int regressions = 0;
+    std::printf("\n%-44s %10s\n", "compared with baseline", "change");
+    for (const BenchResult& result : results) {
+        auto it = baseline.find(result.name);
+        if (it == baseline.end() || it->second <= 0) {
+            std::printf("%-44s %10s\n", result.name.c_str(), "new");
+            continue;
+        }
+        double change = result.opsPerSec / it->second - 1.0;
+        bool regressed = change < -tolerance;
+        regressions += regressed;
+        std::printf("%-44s %+9.1f%%%s\n", result.name.c_str(), change * 100.0, regressed ? "  REGRESSION" : "");
+    }
+    if (regressions > 0) {
+        std::printf("%d benchmark(s) slower than baseline by more than %.0f%%\n", regressions, tolerance * 100.0);
+    }
+    return regressions;
+}
+
+int main(int argc, char* argv[]) {
+    BenchContext context;
+    std::string jsonPath;
+    std::string baselinePath;
+    double tolerance = 0.1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--quick") {
+            context.quick = true;
+            context.minSeconds = 0.05;
+        } else if (arg == "--filter" && i + 1 < argc) {
+            context.filters.push_back(argv[++i]);
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            context.minSeconds = std::atof(argv[++i]);
+        } else if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            tolerance = std::atof(argv[++i]);
+        } else {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            return 2;
+        }
+    }
+    if (context.minSeconds <= 0) context.minSeconds = 0.25;
+
+    // 先读基线，文件有误时不必白跑一遍
+    std::map<std::string, double> baseline;
+    if (!baselinePath.empty() && !readJson(baselinePath, baseline)) return 2;
+
+    runEngineBenchmarks(context);
+    runRngBenchmarks(context);
+    runPolicyBenchmarks(context);
+    runEnvBenchmarks(context);
+    runObsBenchmarks(context);
+    runArenaBenchmarks(context);
+    runNetBenchmarks(context);
+#ifdef SNAKE_BENCH_RENDER
+    runRenderBenchmarks(context);
+#endif
+
+    if (!jsonPath.empty() && !writeJson(jsonPath, context.results)) return 2;
+    if (context.failures > 0) {
+        std::cerr << context.failures << " benchmark check(s) failed" << std::endl;
+        return 1;
+    }
+    if (!baselinePath.empty() && compareBaseline(context.results, baseline, tolerance) > 0) return 1;
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include "snake_env.h"
+#include "VecEngine.h"
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <vector>
+
+struct SnakeEnv {
+    SnakeEnv(const SnakeEnvConfig& config)
+            : engine(config.num_envs, config.cols, config.rows, 0), planeBytes(config.cols * config.rows),
+              observations(config.observations), rewards(config.rewards), dones(config.dones),
+              actions(config.num_envs), results(config.num_envs), prevHead(config.num_envs),
+              prevTail(config.num_envs), prevFood(config.num_envs) {}
+
+    VecEngine engine;
+    size_t planeBytes;
+    uint8_t* observations;
+    float* rewards;
+    uint8_t* dones;
+
+    // step() 用的预分配数组，每个棋盘一个元素
+    std::vector<Direction> actions;
+    std::vector<StepResult> results;
+    std::vector<int32_t> prevHead;
+    std::vector<int32_t> prevTail;
+    std::vector<int32_t> prevFood;
+};
+
+namespace {
+
+bool aligned(const void* p) {
+    return reinterpret_cast<uintptr_t>(p) % SNAKE_ENV_ALIGNMENT == 0;
+}
+
+int cellOf(const VecEngine& engine, Position p) {
+    return p.y * engine.cols() + p.x;
+}
+
+// 第 i 个棋盘的三个平面按当前局面整体重写
+void writeBoard(SnakeEnv& env, int i) {
+    uint8_t* obs = env.observations + static_cast<size_t>(i) * SNAKE_ENV_PLANES * env.planeBytes;
+    uint8_t* bodyPlane = obs;
+    uint8_t* headPlane = obs + env.planeBytes;
+    uint8_t* foodPlane = obs + 2 * env.planeBytes;
+    std::memset(obs, 0, SNAKE_ENV_PLANES * env.planeBytes);
+    const VecEngine& engine = env.engine;
+    for (int k = 0; k < engine.length(i); ++k) {
+        bodyPlane[cellOf(engine, engine.segment(i, k))] = 1;
+    }
+    headPlane[cellOf(engine, engine.head(i))] = 1;
+    foodPlane[cellOf(engine, engine.food(i))] = 1;
+}
+
+}
+
+extern "C" {
+
+int snake_env_abi_version(void) {
+    return SNAKE_ENV_ABI_VERSION;
+}
+
+size_t snake_env_observation_bytes(int32_t cols, int32_t rows) {
+    if (cols <= 0 || rows <= 0) {
+        return 0;
+    }
+    return static_cast<size_t>(SNAKE_ENV_PLANES) * cols * rows;
+}
+
+SnakeEnv* snake_env_create(const SnakeEnvConfig* config) {
+    if (!config || config->struct_size < sizeof(SnakeEnvConfig)) {
+        std::cerr << "snake_env_create: config missing or struct_size too small" << std::endl;
+        return nullptr;
+    }
+    // 开局的蛇有三格长，放在中间一行，需要至少 4 列才有地方放食物和转身
+    if (config->num_envs <= 0 || config->cols < 4 || config->rows < 1 ||
+        static_cast<long long>(config->cols) * config->rows > (1 << 24)) {
+        std::cerr << "snake_env_create: invalid size " << config->num_envs << " x " << config->cols << "x"
+                  << config->rows << std::endl;
+        return nullptr;
+    }
+    if (!config->observations || !config->rewards || !config->dones) {
+        std::cerr << "snake_env_create: observation, reward and done buffers are required" << std::endl;
+        return nullptr;
+    }
+    if (!aligned(config->observations) || !aligned(config->rewards) || !aligned(config->dones)) {
+        std::cerr << "snake_env_create: buffers must be " << SNAKE_ENV_ALIGNMENT << "-byte aligned" << std::endl;
+        return nullptr;
+    }
+    // 异常不能穿过 C 接口
+    try {
+        return new SnakeEnv(*config);
+    } catch (const std::bad_alloc&) {
+        std::cerr << "snake_env_create: out of memory" << std::endl;
+        return nullptr;
+    }
+}
+
+void snake_env_reset(SnakeEnv* env, uint32_t seed) {
+    env->engine.reset(seed);
+    for (int i = 0; i < env->engine.count(); ++i) {
+        writeBoard(*env, i);
+        env->rewards[i] = 0.0f;
+        env->dones[i] = 0;
+    }
+}
+
+void snake_env_step(SnakeEnv* env, const int32_t* actions) {
+    VecEngine& engine = env->engine;
+    const int count = engine.count();
+    for (int i = 0; i < count; ++i) {
+        int32_t a = actions[i];
+        env->actions[i] = a >= UP && a <= RIGHT ? static_cast<Direction>(a) : engine.direction(i);
+        env->prevHead[i] = cellOf(engine, engine.head(i));
+        env->prevTail[i] = cellOf(engine, engine.segment(i, engine.length(i) - 1));
+        env->prevFood[i] = cellOf(engine, engine.food(i));
+    }
+
+    engine.step(env->actions.data(), env->results.data());
+
+    // 只改动变化的格子；结束的棋盘已经重开，整体重写
+    for (int i = 0; i < count; ++i) {
+        StepResult result = env->results[i];
+        if (result == STEP_DIED || result == STEP_WON) {
+            writeBoard(*env, i);
+            env->rewards[i] = result == STEP_WON ? 1.0f : -1.0f;
+            env->dones[i] = 1;
+            continue;
+        }
+        uint8_t* obs = env->observations + static_cast<size_t>(i) * SNAKE_ENV_PLANES * env->planeBytes;
+        uint8_t* bodyPlane = obs;
+        uint8_t* headPlane = obs + env->planeBytes;
+        uint8_t* foodPlane = obs + 2 * env->planeBytes;
+        int head = cellOf(engine, engine.head(i));
+        // 先清蛇尾再写蛇头：蛇头可能正好走进刚让出的蛇尾格
+        if (result == STEP_MOVED) {
+            bodyPlane[env->prevTail[i]] = 0;
+        } else {
+            foodPlane[env->prevFood[i]] = 0;
+            foodPlane[cellOf(engine, engine.food(i))] = 1;
+        }
+        bodyPlane[head] = 1;
+        headPlane[env->prevHead[i]] = 0;
+        headPlane[head] = 1;
+        env->rewards[i] = result == STEP_ATE ? 1.0f : 0.0f;
+        env->dones[i] = 0;
+    }
+}
+
+void snake_env_close(SnakeEnv* env) {
+    delete env;
+}
+
+}
@@ -0,0 +1,66 @@
+/* 贪吃蛇训练环境的 C 接口：N 个同尺寸棋盘批量推进，结果直接写进调用方提供的缓冲区
+ *
+ * 观测、奖励、结束标志三块缓冲区在创建时登记，之后每次 reset()/step() 原地更新，
+ * 不分配内存也不整块复制：每步只改动蛇头、蛇尾、食物所在的几个格子，重开的棋盘才整体重写。
+ * 三块缓冲区须按 SNAKE_ENV_ALIGNMENT 字节对齐，在 snake_env_close() 之前保持有效且不要改写观测。
+ *
+ * 观测布局：uint8 [num_envs][SNAKE_ENV_PLANES][rows][cols]，取值 0/1
+ *   平面 0：蛇身（含蛇头）  平面 1：蛇头  平面 2：食物
+ * 奖励：float [num_envs]，吃到食物 +1，死亡 -1，其余 0
+ * 结束标志：uint8 [num_envs]，死亡或填满棋盘时为 1，此时该棋盘已自动以下一个种子重开，观测为新一局
+ * 动作：int32 [num_envs]，0 上 1 下 2 左 3 右；与当前方向相反或超出范围的动作按保持原方向处理
+ */
+#ifndef SNAKE_ENV_H
+#define SNAKE_ENV_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(SNAKE_ENV_BUILD)
+#define SNAKE_ENV_API __declspec(dllexport)
+#else
+#define SNAKE_ENV_API __declspec(dllimport)
+#endif
+#else
+#define SNAKE_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 接口有不兼容的改动时加一 */
+#define SNAKE_ENV_ABI_VERSION 1
+#define SNAKE_ENV_ALIGNMENT 64
+#define SNAKE_ENV_PLANES 3
+
+typedef struct SnakeEnv SnakeEnv;
+
+typedef struct SnakeEnvConfig {
+    uint32_t struct_size; /* 填 sizeof(SnakeEnvConfig)，以后追加字段时据此兼容旧调用方 */
+    int32_t num_envs;
+    int32_t cols;
+    int32_t rows;
+    uint8_t* observations; /* num_envs * snake_env_observation_bytes() 字节 */
+    float* rewards;        /* num_envs 个 */
+    uint8_t* dones;        /* num_envs 个 */
+} SnakeEnvConfig;
+
+SNAKE_ENV_API int snake_env_abi_version(void);
+/* 单个棋盘的观测字节数 */
+SNAKE_ENV_API size_t snake_env_observation_bytes(int32_t cols, int32_t rows);
+
+/* 参数不合法或缓冲区未对齐时返回 NULL，原因写到 stderr；创建后需先 reset() */
+SNAKE_ENV_API SnakeEnv* snake_env_create(const SnakeEnvConfig* config);
+/* 第 i 个棋盘第 k 局的种子为 seed + i + k * num_envs；重写全部观测，奖励与结束标志清零 */
+SNAKE_ENV_API void snake_env_reset(SnakeEnv* env, uint32_t seed);
+/* actions 为 num_envs 个动作 */
+SNAKE_ENV_API void snake_env_step(SnakeEnv* env, const int32_t* actions);
+SNAKE_ENV_API void snake_env_close(SnakeEnv* env);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SNAKE_ENV_H */
@@ -0,0 +1,143 @@
+#include "AStarPolicy.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+struct OpenOrder {
+    template <class Node>
+    bool operator()(const Node& a, const Node& b) const {
+        return a.f > b.f || (a.f == b.f && a.g < b.g);
+    }
+};
+
+}
+
+AStarPolicy::AStarPolicy()
+        : cursor(0), plannedFood({-1, -1}), expectedHead({-1, -1}), searchId(0), decisionCount(0), planCount(0),
+          expandedCount(0) {}
+
+void AStarPolicy::reset() {
+    path.clear();
+    cursor = 0;
+}
+
+Direction AStarPolicy::decide(const SnakeEngine& engine) {
+    ++decisionCount;
+    Position head = engine.body().front();
+    bool valid = cursor < path.size() && engine.food() == plannedFood && head == expectedHead &&
+                 passable(engine, advance(head, static_cast<Direction>(path[cursor])), 1);
+    if (!valid) {
+        ++planCount;
+        if (!plan(engine)) {
+            path.clear();
+            return fallback(engine);
+        }
+    }
+    Direction next = static_cast<Direction>(path[cursor++]);
+    expectedHead = advance(head, next);
+    return next;
+}
+
+bool AStarPolicy::passable(const SnakeEngine& engine, Position cell, int arrival) const {
+    if (!engine.occupancy().inside(cell.x, cell.y)) {
+        return false;
+    }
+    int segment = engine.segmentAt(cell);
+    return segment < 0 || arrival >= engine.body().size() - segment;
+}
+
+void AStarPolicy::prepare(int cells) {
+    if (static_cast<int>(stamp.size()) != cells) {
+        stamp.assign(cells, 0);
+        arrival.resize(cells);
+        cameFrom.resize(cells);
+        searchId = 0;
+    }
+    if (++searchId == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        searchId = 1;
+    }
+    open.clear();
+}
+
+bool AStarPolicy::plan(const SnakeEngine& engine) {
+    SNAKE_TRACE_ZONE("AStarPolicy::plan");
+    const int cols = engine.cols();
+    prepare(cols * engine.rows());
+    const Position head = engine.body().front();
+    const Position food = engine.food();
+    const int start = head.y * cols + head.x;
+    const int goal = food.y * cols + food.x;
+
+    stamp[start] = searchId;
+    arrival[start] = 0;
+    open.push_back({std::abs(food.x - head.x) + std::abs(food.y - head.y), 0, start});
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), OpenOrder());
+        OpenNode node = open.back();
+        open.pop_back();
+        // 同一格可能入堆多次，只处理最新的一次
+        if (node.g != arrival[node.cell]) {
+            continue;
+        }
+        ++expandedCount;
+        if (node.cell == goal) {
+            // 从食物沿来路倒推回蛇头
+            path.clear();
+            for (int cell = goal; cell != start;) {
+                Direction d = static_cast<Direction>(cameFrom[cell]);
+                path.push_back(static_cast<uint8_t>(d));
+                Position back = advance({cell % cols, cell / cols}, opposite(d));
+                cell = back.y * cols + back.x;
+            }
+            std::reverse(path.begin(), path.end());
+            cursor = 0;
+            plannedFood = food;
+            expectedHead = head;
+            return true;
+        }
+
+        const Position p = {node.cell % cols, node.cell / cols};
+        const int g = node.g + 1;
+        for (int d = 0; d < 4; ++d) {
+            Position next = advance(p, static_cast<Direction>(d));
+            if (!engine.occupancy().inside(next.x, next.y)) {
+                continue;
+            }
+            int cell = next.y * cols + next.x;
+            if ((stamp[cell] == searchId && arrival[cell] <= g) || !passable(engine, next, g)) {
+                continue;
+            }
+            stamp[cell] = searchId;
+            arrival[cell] = g;
+            cameFrom[cell] = static_cast<uint8_t>(d);
+            open.push_back({g + std::abs(food.x - next.x) + std::abs(food.y - next.y), g, cell});
+            std::push_heap(open.begin(), open.end(), OpenOrder());
+        }
+    }
+    return false;
+}
+
+Direction AStarPolicy::fallback(const SnakeEngine& engine) const {
+    // 在能走的方向里挑下一步之后四周可走格子最多的，相同时保持原方向
+    const Position head = engine.body().front();
+    Direction best = engine.direction();
+    int bestScore = -1;
+    for (int d = 0; d < 4; ++d) {
+        Position next = advance(head, static_cast<Direction>(d));
+        if (!passable(engine, next, 1)) {
+            continue;
+        }
+        int score = 0;
+        for (int e = 0; e < 4; ++e) {
+            score += passable(engine, advance(next, static_cast<Direction>(e)), 2);
+        }
+        if (score > bestScore || (score == bestScore && d == engine.direction())) {
+            best = static_cast<Direction>(d);
+            bestScore = score;
+        }
+    }
+    return best;
+}
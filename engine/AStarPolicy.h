@@ -0,0 +1,56 @@
+#ifndef SNAKE_ASTAR_POLICY_H
+#define SNAKE_ASTAR_POLICY_H
+
+#include "Policy.h"
+#include <cstdint>
+#include <vector>
+
+// 用 A* 从蛇头寻路到食物，路径跨逻辑帧缓存，只在失效时重算：
+// 食物变了、蛇头不在计划的位置上（外部重开或改动了局面）或路径走完
+// 蛇身格子按“几步后腾出”处理：从蛇头数第 k 节在 size - k 步后让出，走到那里时已可进入
+// 找不到路径时退而求其次，走向四周空格最多的安全方向
+class AStarPolicy : public Policy {
+public:
+    AStarPolicy();
+
+    void reset() override;
+    Direction decide(const SnakeEngine& engine) override;
+
+    // 统计：调用次数、寻路次数、累计展开的格子数
+    long long decisions() const { return decisionCount; }
+    long long plans() const { return planCount; }
+    long long expanded() const { return expandedCount; }
+
+private:
+    // 把路径（按走的顺序存放方向）写进 path，找不到时返回 false
+    bool plan(const SnakeEngine& engine);
+    Direction fallback(const SnakeEngine& engine) const;
+    // 第 arrival 步走进 cell 是否安全
+    bool passable(const SnakeEngine& engine, Position cell, int arrival) const;
+    void prepare(int cells);
+
+    // 缓存的计划：path[cursor] 为下一步方向，expectedHead 为执行到此时蛇头应在的位置
+    std::vector<uint8_t> path;
+    size_t cursor;
+    Position plannedFood;
+    Position expectedHead;
+
+    // 搜索用的逐格数组，用 stamp 标记本次搜索写过的格子，省去每次清零
+    std::vector<uint32_t> stamp;
+    std::vector<int> arrival;
+    std::vector<uint8_t> cameFrom;
+    // 待展开的格子（二叉堆），f 小的优先，f 相同时 g 大的优先（更靠近食物）
+    struct OpenNode {
+        int f;
+        int g;
+        int cell;
+    };
+    std::vector<OpenNode> open;
+    uint32_t searchId;
+
+    long long decisionCount;
+    long long planCount;
+    long long expandedCount;
+};
+
+#endif // SNAKE_ASTAR_POLICY_H
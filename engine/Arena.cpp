@@ -0,0 +1,211 @@
+#include "Arena.h"
+#include "Trace.h"
+#include <algorithm>
+
+namespace {
+
+// 随机取空格的尝试次数：棋盘大多是空格时几次之内就能命中，挤满时放弃，下一步再试
+const int FOOD_ATTEMPTS = 64;
+const int SPAWN_ATTEMPTS = 64;
+
+}
+
+const int ArenaBody::INITIAL_CAPACITY;
+const int32_t Arena::FREE;
+const int32_t Arena::FOOD_BASE;
+
+Arena::Arena(int cols, int rows, int snakes, int foods, unsigned int seed)
+        : boardCols(cols), boardRows(rows), targetFoods(foods), aliveSnakes(0), tickCount(0), snakes(snakes),
+          owners(static_cast<size_t>(cols) * rows, FREE), nextCell(snakes), grows(snakes),
+          claims(static_cast<size_t>(cols) * rows, 0), claimStamp(0) {
+    reset(seed);
+}
+
+void Arena::reset(unsigned int seed) {
+    rng.seed(seed);
+    std::fill(owners.begin(), owners.end(), FREE);
+    std::fill(claims.begin(), claims.end(), 0);
+    claimStamp = 0;
+    foodCells.clear();
+    placedFoods.clear();
+    aliveSnakes = 0;
+    tickCount = 0;
+    for (ArenaSnake& s : snakes) {
+        s.body.clear();
+        s.dir = RIGHT;
+        s.alive = false;
+    }
+    for (int i = 0; i < snakeCount(); ++i) {
+        spawn(i);
+    }
+    while (static_cast<int>(foodCells.size()) < targetFoods && placeFood()) {
+    }
+}
+
+bool Arena::spawn(int i) {
+    ArenaSnake& s = snakes[i];
+    if (s.alive || boardCols < 3) {
+        return false;
+    }
+    const int cells = boardCols * boardRows;
+    for (int attempt = 0; attempt < SPAWN_ATTEMPTS; ++attempt) {
+        int head = static_cast<int>(rng.bounded(static_cast<uint32_t>(cells)));
+        Direction dir = rng.bounded(2) ? RIGHT : LEFT;
+        int x = head % boardCols;
+        int step = dir == RIGHT ? -1 : 1;
+        if (x + 2 * step < 0 || x + 2 * step >= boardCols) {
+            continue;
+        }
+        if (owners[head] != FREE || owners[head + step] != FREE || owners[head + 2 * step] != FREE) {
+            continue;
+        }
+        s.body.clear();
+        for (int k = 2; k >= 0; --k) {
+            s.body.pushFront(head + k * step);
+            owners[head + k * step] = i;
+        }
+        s.dir = static_cast<uint8_t>(dir);
+        s.alive = true;
+        ++aliveSnakes;
+        return true;
+    }
+    return false;
+}
+
+void Arena::kill(int i) {
+    ArenaSnake& s = snakes[i];
+    for (int k = 0; k < s.body.size(); ++k) {
+        owners[s.body[k]] = FREE;
+    }
+    s.body.clear();
+    s.alive = false;
+    --aliveSnakes;
+}
+
+bool Arena::placeFood() {
+    const uint32_t cells = static_cast<uint32_t>(boardCols * boardRows);
+    for (int attempt = 0; attempt < FOOD_ATTEMPTS; ++attempt) {
+        int cell = static_cast<int>(rng.bounded(cells));
+        if (owners[cell] == FREE) {
+            owners[cell] = FOOD_BASE - static_cast<int32_t>(foodCells.size());
+            foodCells.push_back(cell);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Arena::removeFood(int cell) {
+    // 与最后一个食物交换后删除
+    int k = FOOD_BASE - owners[cell];
+    int last = foodCells.back();
+    foodCells[k] = last;
+    owners[last] = FOOD_BASE - k;
+    foodCells.pop_back();
+    owners[cell] = FREE;
+}
+
+void Arena::step(const Direction* actions, StepResult* results) {
+    SNAKE_TRACE_ZONE("Arena::step");
+    ++tickCount;
+    if (++claimStamp >= (1u << 31)) {
+        std::fill(claims.begin(), claims.end(), 0);
+        claimStamp = 1;
+    }
+    const int count = snakeCount();
+
+    // 算出蛇头要进入的格子；不增长的蛇先收回蛇尾，别的蛇（或自己）可以走进让出的格子
+    for (int i = 0; i < count; ++i) {
+        ArenaSnake& s = snakes[i];
+        if (!s.alive) {
+            results[i] = STEP_DIED;
+            continue;
+        }
+        uint8_t a = static_cast<uint8_t>(actions[i]);
+        if (a != (s.dir ^ 1)) {
+            s.dir = a;
+        }
+        Position next = advance(head(i), static_cast<Direction>(s.dir));
+        bool inside = next.x >= 0 && next.x < boardCols && next.y >= 0 && next.y < boardRows;
+        int cell = inside ? next.y * boardCols + next.x : -1;
+        nextCell[i] = cell;
+        grows[i] = inside && owners[cell] <= FOOD_BASE;
+        if (!grows[i]) {
+            owners[s.body.back()] = FREE;
+            s.body.popBack();
+        }
+    }
+
+    // 认领蛇头要进入的格子，同一格被认领两次即为蛇头相撞
+    for (int i = 0; i < count; ++i) {
+        int cell = nextCell[i];
+        if (!snakes[i].alive || cell < 0) continue;
+        if ((claims[cell] >> 1) == claimStamp) {
+            claims[cell] |= 1;
+        } else {
+            claims[cell] = claimStamp << 1;
+        }
+    }
+
+    // 先判定全部死亡再移除，同一步里死去的蛇身仍算障碍
+    for (int i = 0; i < count; ++i) {
+        int cell = nextCell[i];
+        if (!snakes[i].alive) continue;
+        if (cell < 0 || owners[cell] >= 0 || (claims[cell] & 1)) {
+            results[i] = STEP_DIED;
+        } else {
+            results[i] = grows[i] ? STEP_ATE : STEP_MOVED;
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        if (snakes[i].alive && results[i] == STEP_DIED) {
+            kill(i);
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (!snakes[i].alive) continue;
+        int cell = nextCell[i];
+        if (grows[i]) {
+            removeFood(cell);
+        }
+        snakes[i].body.pushFront(cell);
+        owners[cell] = i;
+    }
+
+    // 新放的食物总是追加在 foodCells 末尾
+    size_t before = foodCells.size();
+    while (static_cast<int>(foodCells.size()) < targetFoods && placeFood()) {
+    }
+    placedFoods.assign(foodCells.begin() + before, foodCells.end());
+}
+
+uint64_t Arena::stateHash() const {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (value >> (i * 8)) & 0xff;
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(static_cast<uint64_t>(boardCols));
+    mix(static_cast<uint64_t>(boardRows));
+    mix(static_cast<uint64_t>(tickCount));
+    for (int i = 0; i < snakeCount(); ++i) {
+        const ArenaSnake& s = snakes[i];
+        mix(s.alive ? 1 : 0);
+        mix(s.dir);
+        mix(static_cast<uint64_t>(s.body.size()));
+        for (int k = 0; k < s.body.size(); ++k) {
+            mix(static_cast<uint64_t>(s.body[k]));
+        }
+    }
+    mix(foodCells.size());
+    for (int cell : foodCells) {
+        mix(static_cast<uint64_t>(cell));
+    }
+    for (int i = 0; i < 4; ++i) {
+        mix(rng.state(i));
+    }
+    return hash;
+}
@@ -0,0 +1,127 @@
+#ifndef SNAKE_ARENA_H
+#define SNAKE_ARENA_H
+
+#include "SnakeEngine.h"
+#include <vector>
+#include <cstdint>
+
+// 多蛇对战用的蛇身：按格子编号存放的环形缓冲区，容量为 2 的幂，写满时翻倍
+// 蛇很多、大多很短，不像 SnakeBody 那样按棋盘大小预留
+class ArenaBody {
+public:
+    ArenaBody() : cells(INITIAL_CAPACITY), headIndex(0), count(0) {}
+
+    int size() const { return count; }
+    // 从蛇头数起的第 k 节
+    int operator[](int k) const { return cells[(headIndex + k) & (cells.size() - 1)]; }
+    int back() const { return (*this)[count - 1]; }
+
+    void pushFront(int cell) {
+        if (count == static_cast<int>(cells.size())) {
+            // 按从蛇头到蛇尾的顺序搬到两倍大的缓冲区开头
+            std::vector<int32_t> grown(cells.size() * 2);
+            for (int k = 0; k < count; ++k) {
+                grown[k] = (*this)[k];
+            }
+            cells.swap(grown);
+            headIndex = 0;
+        }
+        headIndex = (headIndex - 1) & static_cast<int>(cells.size() - 1);
+        cells[headIndex] = cell;
+        ++count;
+    }
+    void popBack() { --count; }
+    void clear() { headIndex = 0; count = 0; }
+
+private:
+    static const int INITIAL_CAPACITY = 8;
+
+    std::vector<int32_t> cells;
+    int headIndex;
+    int count;
+};
+
+// 多蛇对战：同一块棋盘上有很多条蛇和很多个食物，撞到任何蛇身（包括自己）或墙即死
+// 所有格子共用一张归属表（格子 -> 蛇的编号），碰撞只查蛇头要进入的格子，
+// 每步的开销与蛇的条数成正比，与蛇身总长无关
+class Arena {
+public:
+    // 归属表中的空格；食物记为 FOOD_BASE - k（k 为食物编号），蛇身记为蛇的编号
+    static const int32_t FREE = -1;
+    static const int32_t FOOD_BASE = -2;
+
+    // snakes 条三格长的蛇随机放置，棋盘上始终保持 foods 个食物（空格不够时尽量多放）
+    Arena(int cols, int rows, int snakes, int foods, unsigned int seed);
+
+    void reset(unsigned int seed);
+    // 所有活着的蛇同时走一步；actions 与 results 均为 snakeCount() 个元素，与当前方向相反的动作会被忽略
+    // 判定顺序：不增长的蛇先收回蛇尾，再检查各蛇头要进入的格子：出界、有蛇身，或与别的蛇头进入同一格都会死
+    // 死去的蛇整条移除；已经死了的蛇结果保持 STEP_DIED，直到 spawn() 重新放置
+    void step(const Direction* actions, StepResult* results);
+    // 把一条死去的蛇重新随机放到棋盘上（三格长，横向，朝向远离蛇身的一侧）；找不到空位时返回 false
+    bool spawn(int i);
+
+    int cols() const { return boardCols; }
+    int rows() const { return boardRows; }
+    int snakeCount() const { return static_cast<int>(snakes.size()); }
+    int aliveCount() const { return aliveSnakes; }
+    long long ticks() const { return tickCount; }
+
+    bool isAlive(int i) const { return snakes[i].alive; }
+    int length(int i) const { return snakes[i].body.size(); }
+    Direction direction(int i) const { return static_cast<Direction>(snakes[i].dir); }
+    Position head(int i) const { return segment(i, 0); }
+    // 第 i 条蛇从蛇头数起的第 k 节
+    Position segment(int i, int k) const {
+        int cell = snakes[i].body[k];
+        return {cell % boardCols, cell / boardCols};
+    }
+
+    // 占据该格的蛇的编号，没有蛇时返回 -1
+    int ownerAt(Position p) const {
+        int32_t owner = owners[p.y * boardCols + p.x];
+        return owner >= 0 ? owner : -1;
+    }
+    bool hasFood(Position p) const { return owners[p.y * boardCols + p.x] <= FOOD_BASE; }
+    int foodCount() const { return static_cast<int>(foodCells.size()); }
+    Position food(int k) const { return {foodCells[k] % boardCols, foodCells[k] / boardCols}; }
+    // 上一次 step() 末尾补上的食物（联机快照据此记录食物的变化）
+    int placedFoodCount() const { return static_cast<int>(placedFoods.size()); }
+    Position placedFood(int k) const { return {placedFoods[k] % boardCols, placedFoods[k] / boardCols}; }
+
+    // 整个局面（含随机数状态）的 64 位 FNV-1a 哈希
+    uint64_t stateHash() const;
+
+private:
+    struct ArenaSnake {
+        ArenaBody body;
+        uint8_t dir;
+        bool alive;
+    };
+
+    void kill(int i);
+    // 随机挑一个空格放食物，最多试 FOOD_ATTEMPTS 次
+    bool placeFood();
+    void removeFood(int cell);
+
+    int boardCols;
+    int boardRows;
+    int targetFoods;
+    int aliveSnakes;
+    long long tickCount;
+    Rng rng;
+    std::vector<ArenaSnake> snakes;
+    std::vector<int32_t> owners;
+    std::vector<int32_t> foodCells;
+    std::vector<int32_t> placedFoods;
+
+    // step() 的临时数组：蛇头要进入的格子、是否吃到食物
+    std::vector<int32_t> nextCell;
+    std::vector<uint8_t> grows;
+    // 蛇头认领表（判定蛇头相撞）：每格记 claimStamp * 2，本步第二次被认领时最低位置 1，
+    // 换一步只需改 claimStamp，不必清空整张表
+    std::vector<uint32_t> claims;
+    uint32_t claimStamp;
+};
+
+#endif // SNAKE_ARENA_H
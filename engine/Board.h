@@ -0,0 +1,170 @@
+#ifndef SNAKE_BOARD_H
+#define SNAKE_BOARD_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// 枚举方向
+enum Direction { UP, DOWN, LEFT, RIGHT };
+
+// 位置结构体（格子坐标）
+struct Position {
+    int x, y;
+};
+
+inline bool operator==(const Position& a, const Position& b) { return a.x == b.x && a.y == b.y; }
+inline bool operator!=(const Position& a, const Position& b) { return !(a == b); }
+
+// 反方向
+inline Direction opposite(Direction d) {
+    switch (d) {
+        case UP: return DOWN;
+        case DOWN: return UP;
+        case LEFT: return RIGHT;
+        default: return LEFT;
+    }
+}
+
+// 相邻两格之间的方向（from 走一步到 to）
+inline Direction directionTo(Position from, Position to) {
+    if (to.x == from.x) {
+        return to.y < from.y ? UP : DOWN;
+    }
+    return to.x < from.x ? LEFT : RIGHT;
+}
+
+// 沿方向走一格
+inline Position advance(Position p, Direction d) {
+    switch (d) {
+        case UP: --p.y; break;
+        case DOWN: ++p.y; break;
+        case LEFT: --p.x; break;
+        case RIGHT: ++p.x; break;
+    }
+    return p;
+}
+
+// 蛇身环形缓冲区：容量固定，头尾下标循环移动，移动一步 O(1) 且不分配内存
+// 下标 0 为蛇头，size() - 1 为蛇尾
+class SnakeBody {
+public:
+    explicit SnakeBody(int capacity) : cells(capacity), headIndex(0), count(0) {}
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    const Position& operator[](int i) const {
+        int index = headIndex + i;
+        if (index >= static_cast<int>(cells.size())) index -= static_cast<int>(cells.size());
+        return cells[index];
+    }
+    const Position& front() const { return cells[headIndex]; }
+    const Position& back() const { return (*this)[count - 1]; }
+
+    // 蛇头在环形缓冲区中的槽位；某一节的槽位在它存在期间不变，配合 CellSlotMap 可由格子反查是第几节
+    int headSlot() const { return headIndex; }
+    int indexOfSlot(int slot) const {
+        int i = slot - headIndex;
+        return i < 0 ? i + static_cast<int>(cells.size()) : i;
+    }
+
+    // 在蛇头前插入新的一格
+    void pushFront(const Position& p) {
+        headIndex = (headIndex == 0 ? static_cast<int>(cells.size()) : headIndex) - 1;
+        cells[headIndex] = p;
+        ++count;
+    }
+    // 去掉蛇尾
+    void popBack() { --count; }
+    void clear() { headIndex = 0; count = 0; }
+
+private:
+    std::vector<Position> cells;
+    int headIndex;
+    int count;
+};
+
+// 占用位图：每个格子一位，记录该格是否被蛇身占据
+class OccupancyGrid {
+public:
+    OccupancyGrid(int cols, int rows) : cols(cols), rows(rows), bits((cols * rows + 63) / 64, 0) {}
+
+    bool inside(int cx, int cy) const { return cx >= 0 && cx < cols && cy >= 0 && cy < rows; }
+    bool test(int cx, int cy) const {
+        int index = cy * cols + cx;
+        return (bits[index >> 6] >> (index & 63)) & 1;
+    }
+    void set(int cx, int cy) {
+        int index = cy * cols + cx;
+        bits[index >> 6] |= uint64_t(1) << (index & 63);
+    }
+    void clear(int cx, int cy) {
+        int index = cy * cols + cx;
+        bits[index >> 6] &= ~(uint64_t(1) << (index & 63));
+    }
+    void reset() { std::fill(bits.begin(), bits.end(), 0); }
+    // 按格子编号 y * cols + x 逐位排列的原始位图，共 (cols * rows + 63) / 64 个字
+    const uint64_t* words() const { return bits.data(); }
+
+private:
+    int cols;
+    int rows;
+    std::vector<uint64_t> bits;
+};
+
+// 格子到蛇身槽位的反查表：蛇头进入某格时记下当时的 SnakeBody::headSlot()
+// 蛇尾离开时不必清除，先查占用位图确认该格有蛇身即可
+class CellSlotMap {
+public:
+    CellSlotMap(int cols, int rows) : cols(cols), slots(cols * rows, -1) {}
+
+    void set(Position cell, int slot) { slots[cell.y * cols + cell.x] = slot; }
+    int get(Position cell) const { return slots[cell.y * cols + cell.x]; }
+
+private:
+    int cols;
+    std::vector<int> slots;
+};
+
+// 空闲格子集合：cells 为紧凑的空格数组，slotOf 记录每个格子在数组中的位置
+// 占用时与末尾交换后删除，释放时追加到末尾，随机取空格始终 O(1)
+class FreeCellSet {
+public:
+    FreeCellSet(int cols, int rows) : cols(cols), cells(cols * rows), slotOf(cols * rows) { reset(); }
+
+    int size() const { return static_cast<int>(cells.size()); }
+    bool empty() const { return cells.empty(); }
+    Position at(int slot) const { return {cells[slot] % cols, cells[slot] / cols}; }
+
+    void occupy(int cx, int cy) {
+        int index = cy * cols + cx;
+        int slot = slotOf[index];
+        if (slot < 0) return;
+        int last = cells.back();
+        cells[slot] = last;
+        slotOf[last] = slot;
+        cells.pop_back();
+        slotOf[index] = -1;
+    }
+    void release(int cx, int cy) {
+        int index = cy * cols + cx;
+        if (slotOf[index] >= 0) return;
+        slotOf[index] = static_cast<int>(cells.size());
+        cells.push_back(index);
+    }
+    void reset() {
+        cells.resize(slotOf.size());
+        for (int i = 0; i < static_cast<int>(cells.size()); ++i) {
+            cells[i] = i;
+            slotOf[i] = i;
+        }
+    }
+
+private:
+    int cols;
+    std::vector<int> cells;
+    std::vector<int> slotOf;
+};
+
+#endif // SNAKE_BOARD_H
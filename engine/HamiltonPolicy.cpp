@@ -0,0 +1,140 @@
+#include "HamiltonPolicy.h"
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace {
+
+// 蛇长超过棋盘的这一比例后不再抄近路，只沿回路走，保证最终填满
+const double SHORTCUT_FILL = 0.5;
+// 抄近路后蛇头到蛇尾之间至少还要留出的空格数，吃到食物变长时不会追上蛇尾
+const int SHORTCUT_MARGIN = 2;
+
+}
+
+std::shared_ptr<const HamiltonCycle> HamiltonCycle::forBoard(int cols, int rows) {
+    if (cols < 2 || rows < 2 || (cols % 2 != 0 && rows % 2 != 0)) {
+        return nullptr;
+    }
+    static std::mutex cacheMutex;
+    static std::map<std::pair<int, int>, std::shared_ptr<const HamiltonCycle>> cache;
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::shared_ptr<const HamiltonCycle>& cycle = cache[std::make_pair(cols, rows)];
+    if (!cycle) {
+        cycle = std::make_shared<HamiltonCycle>(cols, rows);
+    }
+    return cycle;
+}
+
+HamiltonCycle::HamiltonCycle(int cols, int rows) {
+    const int total = cols * rows;
+    cells.reserve(total);
+    cells.push_back(0);
+    if (rows % 2 == 0) {
+        for (int y = 0; y < rows; ++y) {
+            if (y % 2 == 0) {
+                for (int x = 1; x < cols; ++x) cells.push_back(y * cols + x);
+            } else {
+                for (int x = cols - 1; x >= 1; --x) cells.push_back(y * cols + x);
+            }
+        }
+        for (int y = rows - 1; y >= 1; --y) cells.push_back(y * cols);
+    } else {
+        for (int x = 0; x < cols; ++x) {
+            if (x % 2 == 0) {
+                for (int y = 1; y < rows; ++y) cells.push_back(y * cols + x);
+            } else {
+                for (int y = rows - 1; y >= 1; --y) cells.push_back(y * cols + x);
+            }
+        }
+        for (int x = cols - 1; x >= 1; --x) cells.push_back(x);
+    }
+
+    indices.resize(total);
+    forwardDirs.resize(total);
+    backwardDirs.resize(total);
+    for (int i = 0; i < total; ++i) {
+        int cell = cells[i];
+        int next = cells[(i + 1) % total];
+        Position p = {cell % cols, cell / cols};
+        indices[cell] = i;
+        forwardDirs[cell] = static_cast<uint8_t>(directionTo(p, {next % cols, next / cols}));
+        backwardDirs[next] = static_cast<uint8_t>(opposite(static_cast<Direction>(forwardDirs[cell])));
+    }
+}
+
+HamiltonPolicy::HamiltonPolicy()
+        : cycleCols(0), cycleRows(0), aligned(false), reversed(false), expectedHead({-1, -1}) {}
+
+void HamiltonPolicy::reset() {
+    expectedHead = {-1, -1};
+    astar.reset();
+}
+
+void HamiltonPolicy::align(const SnakeEngine& engine) {
+    aligned = false;
+    astar.reset();
+    if (!cycle) {
+        return;
+    }
+    // 从蛇尾到蛇头逐节前进，累计的步数不超过一圈即为按回路顺序排列
+    const SnakeBody& snake = engine.body();
+    const int cols = engine.cols();
+    for (int pass = 0; pass < 2 && !aligned; ++pass) {
+        reversed = pass == 1;
+        long long span = 0;
+        bool ordered = true;
+        for (int i = snake.size() - 1; i > 0 && ordered; --i) {
+            int d = distance(snake[i].y * cols + snake[i].x, snake[i - 1].y * cols + snake[i - 1].x);
+            span += d;
+            ordered = d > 0 && span < cycle->size();
+        }
+        aligned = ordered;
+    }
+}
+
+Direction HamiltonPolicy::decide(const SnakeEngine& engine) {
+    if (engine.cols() != cycleCols || engine.rows() != cycleRows) {
+        cycle = HamiltonCycle::forBoard(engine.cols(), engine.rows());
+        cycleCols = engine.cols();
+        cycleRows = engine.rows();
+        expectedHead = {-1, -1};
+    }
+    const SnakeBody& snake = engine.body();
+    const Position head = snake.front();
+    // 蛇头不在预期位置说明换了一局或局面被改动，重新检查蛇身顺序
+    if (head != expectedHead) {
+        align(engine);
+    }
+    if (!aligned) {
+        Direction next = astar.decide(engine);
+        expectedHead = advance(head, next);
+        return next;
+    }
+
+    const int cols = engine.cols();
+    const int headCell = head.y * cols + head.x;
+    Direction best = reversed ? cycle->backward(headCell) : cycle->forward(headCell);
+    if (snake.size() < cycle->size() * SHORTCUT_FILL) {
+        // 蛇身都在回路上蛇尾到蛇头这一段，蛇头往前到蛇尾之间全是空格；
+        // 跳到这段空格中更靠前的邻格仍保持顺序，只要不越过食物、离蛇尾留有余量
+        const Position food = engine.food();
+        const Position tail = snake.back();
+        const int toFood = distance(headCell, food.y * cols + food.x);
+        const int toTail = distance(headCell, tail.y * cols + tail.x);
+        int bestGain = 1;
+        for (int d = 0; d < 4; ++d) {
+            Position next = advance(head, static_cast<Direction>(d));
+            if (!engine.occupancy().inside(next.x, next.y) || engine.occupancy().test(next.x, next.y)) {
+                continue;
+            }
+            int gain = distance(headCell, next.y * cols + next.x);
+            if (gain > bestGain && gain <= toFood && toTail - gain >= SHORTCUT_MARGIN) {
+                best = static_cast<Direction>(d);
+                bestGain = gain;
+            }
+        }
+    }
+    expectedHead = advance(head, best);
+    return best;
+}
@@ -0,0 +1,62 @@
+#ifndef SNAKE_HAMILTON_POLICY_H
+#define SNAKE_HAMILTON_POLICY_H
+
+#include "AStarPolicy.h"
+#include <memory>
+#include <vector>
+
+// 经过棋盘每一格恰好一次的回路。行数为偶数时第 0 列留作回程，其余格子逐行来回扫；
+// 否则列数须为偶数，按列来回扫，第 0 行留作回程。两边都是奇数（或某一边只有 1 格）时不存在
+class HamiltonCycle {
+public:
+    // 同一尺寸只构造一次，各局、各线程共用；不存在回路时返回空指针
+    static std::shared_ptr<const HamiltonCycle> forBoard(int cols, int rows);
+
+    int size() const { return static_cast<int>(cells.size()); }
+    // 回路上第 i 个格子（格子编号 y * cols + x）
+    int cellAt(int i) const { return cells[i]; }
+    const std::vector<int>& order() const { return cells; }
+    // 格子在回路上的序号
+    int indexOf(int cell) const { return indices[cell]; }
+    // 沿回路正向、反向走一步的方向
+    Direction forward(int cell) const { return static_cast<Direction>(forwardDirs[cell]); }
+    Direction backward(int cell) const { return static_cast<Direction>(backwardDirs[cell]); }
+
+    HamiltonCycle(int cols, int rows);
+
+private:
+    std::vector<int> cells;
+    std::vector<int> indices;
+    std::vector<uint8_t> forwardDirs;
+    std::vector<uint8_t> backwardDirs;
+};
+
+// 沿哈密顿回路走，必然能填满棋盘；蛇不长时在不会困住蛇尾的前提下抄近路去吃食物
+// 前提是蛇身按回路顺序排列（从蛇尾到蛇头序号递增），开局时按蛇的朝向选定正向或反向回路；
+// 棋盘没有回路或蛇身不满足前提时整局交给 A*
+class HamiltonPolicy : public Policy {
+public:
+    HamiltonPolicy();
+
+    void reset() override;
+    Direction decide(const SnakeEngine& engine) override;
+
+private:
+    // 检查蛇身是否按回路顺序排列并选定方向
+    void align(const SnakeEngine& engine);
+    // 沿所选方向从 a 走到 b 的步数
+    int distance(int a, int b) const {
+        int d = reversed ? cycle->indexOf(a) - cycle->indexOf(b) : cycle->indexOf(b) - cycle->indexOf(a);
+        return d < 0 ? d + cycle->size() : d;
+    }
+
+    std::shared_ptr<const HamiltonCycle> cycle;
+    int cycleCols;
+    int cycleRows;
+    bool aligned;
+    bool reversed;
+    Position expectedHead;
+    AStarPolicy astar;
+};
+
+#endif // SNAKE_HAMILTON_POLICY_H
@@ -0,0 +1,74 @@
+#include "NetClient.h"
+#include "Trace.h"
+#include <chrono>
+#include <thread>
+
+namespace {
+
+// 加入申请的重发间隔
+const int JOIN_RETRY_MS = 100;
+
+}
+
+NetClient::NetClient() : server(UdpSocket::localhost(0)), snakeId(-1), sent(RIGHT), received(0),
+                         buffer(NET_MAX_PACKET) {}
+
+bool NetClient::open(uint16_t serverPort) {
+    server = UdpSocket::localhost(serverPort);
+    snakeId = -1;
+    return socket.open(0);
+}
+
+void NetClient::join() {
+    uint8_t packet = PACKET_JOIN;
+    socket.send(server, &packet, 1);
+}
+
+bool NetClient::connect(uint16_t serverPort, int timeoutMs) {
+    if (!open(serverPort)) {
+        return false;
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (std::chrono::steady_clock::now() < deadline) {
+        join();
+        std::this_thread::sleep_for(std::chrono::milliseconds(JOIN_RETRY_MS));
+        poll();
+        if (joined()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NetClient::poll() {
+    SNAKE_TRACE_ZONE("NetClient::poll");
+    bool snapshot = false;
+    NetAddress from;
+    int size;
+    while ((size = socket.receive(buffer.data(), static_cast<int>(buffer.size()), from)) >= 0) {
+        if (from != server || size == 0) {
+            continue;
+        }
+        received += size;
+        WelcomePacket welcome;
+        if (buffer[0] == PACKET_SNAPSHOT && joined()) {
+            world.apply(buffer.data(), size);
+            snapshot = true;
+        } else if (!joined() && readWelcome(buffer.data(), size, welcome)) {
+            snakeId = welcome.snake;
+            world.setup(welcome.cols, welcome.rows, welcome.snakes);
+        }
+    }
+    // 本机上发出的方向在下一个快照里就已生效；以快照为准，重新放置后的蛇也能对上方向
+    if (snapshot && world.isAlive(snakeId)) {
+        sent = world.direction(snakeId);
+    }
+    return snapshot;
+}
+
+void NetClient::sendInput(Direction dir) {
+    uint8_t packet[16];
+    int size = writeInput({world.tick(), dir}, packet);
+    socket.send(server, packet, size);
+    sent = dir;
+}
@@ -0,0 +1,42 @@
+#ifndef SNAKE_NET_CLIENT_H
+#define SNAKE_NET_CLIENT_H
+
+#include "NetProtocol.h"
+#include "NetSocket.h"
+#include <vector>
+
+// 联机客户端：向本机的服务器申请一条蛇，收快照还原局面，每收到一个快照回复确认与方向
+class NetClient {
+public:
+    NetClient();
+
+    // 绑定本地任意端口；之后用 join() 申请加入，服务器的回复由 poll() 收下
+    bool open(uint16_t serverPort);
+    void join();
+    // 阻塞直到加入成功，期间定时重发申请；超时（服务器没开或已满）返回 false
+    bool connect(uint16_t serverPort, int timeoutMs);
+
+    // 收下所有已到达的包；收到过快照（不论能否应用）时返回 true，此时应调用 sendInput() 回复确认
+    bool poll();
+    // 发送想走的方向，附带已应用的最新快照的 tick
+    void sendInput(Direction dir);
+
+    bool joined() const { return snakeId >= 0; }
+    // 分到的蛇的编号
+    int snake() const { return snakeId; }
+    // 自己的蛇下一步的方向：最近一次发出的方向，收到快照后以快照里的为准
+    Direction direction() const { return sent; }
+    const NetMirror& mirror() const { return world; }
+    long long bytesReceived() const { return received; }
+
+private:
+    UdpSocket socket;
+    NetAddress server;
+    NetMirror world;
+    int snakeId;
+    Direction sent;
+    long long received;
+    std::vector<uint8_t> buffer;
+};
+
+#endif // SNAKE_NET_CLIENT_H
@@ -0,0 +1,462 @@
+#include "NetProtocol.h"
+#include "Trace.h"
+#include <algorithm>
+
+namespace {
+
+// 快照包头：类型、tick、基准 tick、蛇的条数，其后是按位打包的正文
+const int SNAPSHOT_HEADER_BYTES = 11;
+const int WELCOME_BYTES = 9;
+const int INPUT_BYTES = 6;
+
+// 每条蛇在正文里先写两位的种类
+enum SnakeDelta {
+    DELTA_SAME,   // 没有变化
+    DELTA_STEP,   // 走了一步（最常见）：方向
+    DELTA_RUN,    // 其他情况：新蛇头个数、各自的方向、收回的蛇尾节数
+    DELTA_RESET,  // 死去或重新放置：是否活着，活着时为长度、蛇头格子、每一节指向下一节的方向
+};
+
+void putU16(uint8_t* out, uint32_t value) {
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void putU32(uint8_t* out, uint32_t value) {
+    putU16(out, value & 0xffff);
+    putU16(out + 2, value >> 16);
+}
+
+uint32_t getU16(const uint8_t* data) {
+    return data[0] | (static_cast<uint32_t>(data[1]) << 8);
+}
+
+uint32_t getU32(const uint8_t* data) {
+    return getU16(data) | (getU16(data + 2) << 16);
+}
+
+// 低位在前的位流；变长整数每组 3 位数据加 1 位后续标记，小的计数和间隔只占 4 位
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out(out), acc(0), bits(0) {}
+
+    void put(uint32_t value, int count) {
+        acc |= static_cast<uint64_t>(value) << bits;
+        bits += count;
+        while (bits >= 8) {
+            out.push_back(static_cast<uint8_t>(acc));
+            acc >>= 8;
+            bits -= 8;
+        }
+    }
+    void putVarint(uint32_t value) {
+        while (value >= 8) {
+            put((value & 7) | 8, 4);
+            value >>= 3;
+        }
+        put(value, 4);
+    }
+    void flush() {
+        if (bits > 0) {
+            out.push_back(static_cast<uint8_t>(acc));
+        }
+        acc = 0;
+        bits = 0;
+    }
+
+private:
+    std::vector<uint8_t>& out;
+    uint64_t acc;
+    int bits;
+};
+
+// 读过头时 ok 置为 false，之后读到的都是 0
+class BitReader {
+public:
+    BitReader(const uint8_t* data, int size) : ok(true), data(data), size(size), pos(0), acc(0), bits(0) {}
+
+    uint32_t get(int count) {
+        while (bits < count) {
+            if (pos == size) {
+                ok = false;
+                return 0;
+            }
+            acc |= static_cast<uint64_t>(data[pos++]) << bits;
+            bits += 8;
+        }
+        uint32_t value = static_cast<uint32_t>(acc & ((1ull << count) - 1));
+        acc >>= count;
+        bits -= count;
+        return value;
+    }
+    uint32_t getVarint() {
+        uint32_t value = 0;
+        for (int shift = 0; shift <= 30; shift += 3) {
+            uint32_t group = get(4);
+            // 第 11 组只剩两位数据可放，再有高位或续读标志就超出了 32 位
+            if (shift == 30 && (group & 12)) {
+                break;
+            }
+            value |= (group & 7) << shift;
+            if (!(group & 8)) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    bool ok;
+
+private:
+    const uint8_t* data;
+    int size;
+    int pos;
+    uint64_t acc;
+    int bits;
+};
+
+// 升序的格子编号，按与前一个的间隔写
+void putCells(BitWriter& writer, const std::vector<int32_t>& cells) {
+    writer.putVarint(static_cast<uint32_t>(cells.size()));
+    int32_t previous = 0;
+    for (int32_t cell : cells) {
+        writer.putVarint(static_cast<uint32_t>(cell - previous));
+        previous = cell;
+    }
+}
+
+}
+
+int writeWelcome(const WelcomePacket& welcome, uint8_t* out) {
+    out[0] = PACKET_WELCOME;
+    putU16(out + 1, static_cast<uint32_t>(welcome.snake));
+    putU16(out + 3, static_cast<uint32_t>(welcome.cols));
+    putU16(out + 5, static_cast<uint32_t>(welcome.rows));
+    putU16(out + 7, static_cast<uint32_t>(welcome.snakes));
+    return WELCOME_BYTES;
+}
+
+bool readWelcome(const uint8_t* data, int size, WelcomePacket& welcome) {
+    if (size != WELCOME_BYTES || data[0] != PACKET_WELCOME) {
+        return false;
+    }
+    welcome.snake = static_cast<int>(getU16(data + 1));
+    welcome.cols = static_cast<int>(getU16(data + 3));
+    welcome.rows = static_cast<int>(getU16(data + 5));
+    welcome.snakes = static_cast<int>(getU16(data + 7));
+    // 客户端直接按这些尺寸 setup()，棋盘须是单机也能开的大小
+    return welcome.snake < welcome.snakes && validBoardSize(welcome.cols, welcome.rows);
+}
+
+int writeInput(const InputPacket& input, uint8_t* out) {
+    out[0] = PACKET_INPUT;
+    putU32(out + 1, input.ack < 0 ? NET_NO_TICK : static_cast<uint32_t>(input.ack));
+    out[5] = static_cast<uint8_t>(input.dir);
+    return INPUT_BYTES;
+}
+
+bool readInput(const uint8_t* data, int size, InputPacket& input) {
+    if (size != INPUT_BYTES || data[0] != PACKET_INPUT || data[5] > RIGHT) {
+        return false;
+    }
+    uint32_t ack = getU32(data + 1);
+    input.ack = ack == NET_NO_TICK ? -1 : static_cast<long long>(ack);
+    input.dir = static_cast<Direction>(data[5]);
+    return true;
+}
+
+SnapshotHistory::SnapshotHistory() : firstTick(0), records(NET_HISTORY_TICKS) {}
+
+void SnapshotHistory::start(const Arena& arena) {
+    firstTick = arena.ticks();
+    alive.resize(arena.snakeCount());
+    for (int i = 0; i < arena.snakeCount(); ++i) {
+        alive[i] = arena.isAlive(i);
+    }
+}
+
+void SnapshotHistory::record(const Arena& arena, const StepResult* results) {
+    TickRecord& record = records[arena.ticks() % NET_HISTORY_TICKS];
+    record.events.resize(arena.snakeCount());
+    record.foodAdded.clear();
+    record.foodRemoved.clear();
+    for (int i = 0; i < arena.snakeCount(); ++i) {
+        bool nowAlive = arena.isAlive(i);
+        if (nowAlive && results[i] == STEP_ATE) {
+            Position head = arena.head(i);
+            record.foodRemoved.push_back(head.y * arena.cols() + head.x);
+        }
+        if (nowAlive != (alive[i] != 0)) {
+            record.events[i] = EVENT_RESET;
+        } else if (!nowAlive) {
+            record.events[i] = EVENT_NONE;
+        } else {
+            record.events[i] = static_cast<uint8_t>((results[i] == STEP_ATE ? EVENT_ATE : EVENT_MOVED) |
+                                                    (arena.direction(i) << 2));
+        }
+        alive[i] = nowAlive;
+    }
+    for (int k = 0; k < arena.placedFoodCount(); ++k) {
+        Position p = arena.placedFood(k);
+        record.foodAdded.push_back(p.y * arena.cols() + p.x);
+    }
+}
+
+bool SnapshotHistory::encode(const Arena& arena, long long base, std::vector<uint8_t>& packet) {
+    SNAKE_TRACE_ZONE("SnapshotHistory::encode");
+    const long long tick = arena.ticks();
+    const bool full = base < firstTick || base > tick || tick - base > NET_HISTORY_TICKS;
+    const int cols = arena.cols();
+
+    packet.resize(SNAPSHOT_HEADER_BYTES);
+    packet[0] = PACKET_SNAPSHOT;
+    putU32(&packet[1], static_cast<uint32_t>(tick));
+    putU32(&packet[5], full ? NET_NO_TICK : static_cast<uint32_t>(base));
+    putU16(&packet[9], static_cast<uint32_t>(arena.snakeCount()));
+
+    BitWriter writer(packet);
+    for (int i = 0; i < arena.snakeCount(); ++i) {
+        bool reset = full;
+        int retracted = 0;
+        dirs.clear();
+        for (long long t = base + 1; !reset && t <= tick; ++t) {
+            uint8_t event = records[t % NET_HISTORY_TICKS].events[i];
+            if ((event & 3) == EVENT_RESET) {
+                reset = true;
+            } else if ((event & 3) != EVENT_NONE) {
+                dirs.push_back(event >> 2);
+                retracted += (event & 3) == EVENT_MOVED;
+            }
+        }
+
+        if (reset) {
+            writer.put(DELTA_RESET, 2);
+            writer.put(arena.isAlive(i) ? 1 : 0, 1);
+            if (arena.isAlive(i)) {
+                Position head = arena.head(i);
+                writer.putVarint(static_cast<uint32_t>(arena.length(i)));
+                writer.putVarint(static_cast<uint32_t>(head.y * cols + head.x));
+                for (int k = 1; k < arena.length(i); ++k) {
+                    writer.put(directionTo(arena.segment(i, k - 1), arena.segment(i, k)), 2);
+                }
+            }
+        } else if (dirs.empty()) {
+            writer.put(DELTA_SAME, 2);
+        } else if (dirs.size() == 1 && retracted == 1) {
+            writer.put(DELTA_STEP, 2);
+            writer.put(dirs[0], 2);
+        } else {
+            writer.put(DELTA_RUN, 2);
+            writer.putVarint(static_cast<uint32_t>(dirs.size()));
+            for (uint8_t dir : dirs) {
+                writer.put(dir, 2);
+            }
+            writer.putVarint(static_cast<uint32_t>(retracted));
+        }
+    }
+
+    // 食物：先写相对基准少了的格子，再写多出来的格子
+    removedCells.clear();
+    addedCells.clear();
+    if (full) {
+        for (int k = 0; k < arena.foodCount(); ++k) {
+            Position p = arena.food(k);
+            addedCells.push_back(p.y * cols + p.x);
+        }
+        std::sort(addedCells.begin(), addedCells.end());
+    } else {
+        // 同一格在这段时间里可能被吃掉又重新放上：只比较基准时与现在有没有食物
+        foodChanges.clear();
+        for (long long t = base + 1; t <= tick; ++t) {
+            const TickRecord& record = records[t % NET_HISTORY_TICKS];
+            for (int32_t cell : record.foodRemoved) foodChanges.push_back({cell, false});
+            for (int32_t cell : record.foodAdded) foodChanges.push_back({cell, true});
+        }
+        std::stable_sort(foodChanges.begin(), foodChanges.end(),
+                         [](const FoodChange& a, const FoodChange& b) { return a.cell < b.cell; });
+        for (size_t k = 0; k < foodChanges.size();) {
+            size_t last = k;
+            while (last + 1 < foodChanges.size() && foodChanges[last + 1].cell == foodChanges[k].cell) ++last;
+            bool had = !foodChanges[k].added;
+            bool has = foodChanges[last].added;
+            if (had && !has) removedCells.push_back(foodChanges[k].cell);
+            if (!had && has) addedCells.push_back(foodChanges[k].cell);
+            k = last + 1;
+        }
+    }
+    putCells(writer, removedCells);
+    putCells(writer, addedCells);
+    writer.flush();
+    return full;
+}
+
+NetMirror::NetMirror() : boardCols(0), boardRows(0), currentTick(-1) {}
+
+void NetMirror::setup(int cols, int rows, int snakeCount) {
+    boardCols = cols;
+    boardRows = rows;
+    snakes.assign(snakeCount, ArenaBody());
+    owners.assign(static_cast<size_t>(cols) * rows, -1);
+    foodSlots.assign(static_cast<size_t>(cols) * rows, -1);
+    foodCells.clear();
+    currentTick = -1;
+}
+
+bool NetMirror::apply(const uint8_t* data, int size) {
+    SNAKE_TRACE_ZONE("NetMirror::apply");
+    if (size < SNAPSHOT_HEADER_BYTES || data[0] != PACKET_SNAPSHOT ||
+        static_cast<int>(getU16(data + 9)) != snakeCount()) {
+        return false;
+    }
+    long long tick = getU32(data + 1);
+    uint32_t base = getU32(data + 5);
+    bool full = base == NET_NO_TICK;
+    // 过时或重复的包，以及基准不是当前局面的增量包都用不上
+    if (tick <= currentTick || (!full && static_cast<long long>(base) != currentTick)) {
+        return false;
+    }
+    if (full) {
+        clear();
+    }
+    if (!decode(data + SNAPSHOT_HEADER_BYTES, size - SNAPSHOT_HEADER_BYTES, full)) {
+        clear();
+        currentTick = -1;
+        return false;
+    }
+    currentTick = tick;
+    return true;
+}
+
+bool NetMirror::decode(const uint8_t* data, int size, bool full) {
+    BitReader reader(data, size);
+    const uint32_t cellCount = static_cast<uint32_t>(boardCols) * boardRows;
+    auto inside = [this](Position p) { return p.x >= 0 && p.x < boardCols && p.y >= 0 && p.y < boardRows; };
+
+    for (int i = 0; i < snakeCount() && reader.ok; ++i) {
+        ArenaBody& body = snakes[i];
+        uint32_t kind = reader.get(2);
+        if (kind == DELTA_SAME) {
+            continue;
+        }
+        if (kind == DELTA_RESET) {
+            clearSnake(i);
+            if (!reader.get(1)) {
+                continue;
+            }
+            uint32_t length = reader.getVarint();
+            uint32_t head = reader.getVarint();
+            if (length < 2 || length > cellCount || head >= cellCount) {
+                return false;
+            }
+            // 从蛇头往蛇尾解出各节，再从蛇尾起插到前面
+            Position p = {static_cast<int>(head % boardCols), static_cast<int>(head / boardCols)};
+            cells.clear();
+            cells.push_back(static_cast<int32_t>(head));
+            for (uint32_t k = 1; k < length; ++k) {
+                p = advance(p, static_cast<Direction>(reader.get(2)));
+                if (!inside(p)) {
+                    return false;
+                }
+                cells.push_back(p.y * boardCols + p.x);
+            }
+            for (size_t k = cells.size(); k-- > 0;) {
+                body.pushFront(cells[k]);
+                owners[cells[k]] = i;
+            }
+            continue;
+        }
+
+        if (body.size() == 0 || full) {
+            return false;
+        }
+        uint32_t heads = kind == DELTA_STEP ? 1 : reader.getVarint();
+        if (heads > cellCount) {
+            return false;
+        }
+        for (uint32_t k = 0; k < heads; ++k) {
+            Position p = advance(head(i), static_cast<Direction>(reader.get(2)));
+            if (!inside(p)) {
+                return false;
+            }
+            body.pushFront(p.y * boardCols + p.x);
+        }
+        // 收回后至少剩两节、至多占满棋盘；body 此时已含新蛇头，长度不小于 2，减法不会回绕
+        uint32_t retracted = kind == DELTA_STEP ? 1 : reader.getVarint();
+        uint32_t grown = static_cast<uint32_t>(body.size());
+        if (retracted > grown - 2 || grown - retracted > cellCount) {
+            return false;
+        }
+        for (uint32_t k = 0; k < retracted; ++k) {
+            popTail(i);
+        }
+        // 收回蛇尾之后再登记新蛇头：蛇头可能正好走进自己刚让出的格子
+        for (int k = 0; k < static_cast<int>(std::min(heads, static_cast<uint32_t>(body.size()))); ++k) {
+            owners[body[k]] = i;
+        }
+    }
+
+    for (int pass = 0; pass < 2 && reader.ok; ++pass) {
+        bool adding = pass == 1;
+        uint32_t count = reader.getVarint();
+        uint32_t cell = 0;
+        for (uint32_t k = 0; k < count && reader.ok; ++k) {
+            uint32_t gap = reader.getVarint();
+            if (gap >= cellCount) {
+                return false;
+            }
+            cell += gap;
+            if (cell >= cellCount || (foodSlots[cell] >= 0) == adding) {
+                return false;
+            }
+            if (adding) {
+                addFood(static_cast<int>(cell));
+            } else {
+                removeFood(static_cast<int>(cell));
+            }
+        }
+    }
+    return reader.ok;
+}
+
+void NetMirror::clear() {
+    for (ArenaBody& body : snakes) {
+        body.clear();
+    }
+    std::fill(owners.begin(), owners.end(), -1);
+    std::fill(foodSlots.begin(), foodSlots.end(), -1);
+    foodCells.clear();
+}
+
+void NetMirror::clearSnake(int i) {
+    ArenaBody& body = snakes[i];
+    for (int k = 0; k < body.size(); ++k) {
+        if (owners[body[k]] == i) {
+            owners[body[k]] = -1;
+        }
+    }
+    body.clear();
+}
+
+void NetMirror::popTail(int i) {
+    int cell = snakes[i].back();
+    snakes[i].popBack();
+    if (owners[cell] == i) {
+        owners[cell] = -1;
+    }
+}
+
+void NetMirror::addFood(int cell) {
+    foodSlots[cell] = static_cast<int32_t>(foodCells.size());
+    foodCells.push_back(cell);
+}
+
+void NetMirror::removeFood(int cell) {
+    // 与最后一个食物交换后删除
+    int k = foodSlots[cell];
+    int last = foodCells.back();
+    foodCells[k] = last;
+    foodSlots[last] = k;
+    foodCells.pop_back();
+    foodSlots[cell] = -1;
+}
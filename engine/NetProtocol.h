@@ -0,0 +1,135 @@
+#ifndef SNAKE_NET_PROTOCOL_H
+#define SNAKE_NET_PROTOCOL_H
+
+#include "Arena.h"
+#include <cstdint>
+#include <vector>
+
+// 本机联机协议：服务器用 Arena 权威地推进规则，每步给每个客户端发一个快照包；
+// 快照只编码相对客户端最近确认的 tick 的变化（新的蛇头、收回的蛇尾、食物增减），
+// 客户端每收到一个快照就回复确认的 tick 和自己的方向
+
+// 默认端口
+const int NET_DEFAULT_PORT = 7777;
+// UDP 单个数据报的上限
+const int NET_MAX_PACKET = 65507;
+// 服务器保留的历史步数；客户端确认的 tick 更旧时改发完整快照
+const int NET_HISTORY_TICKS = 64;
+// 包里表示“没有 tick”的值：还没收到过快照的确认，或完整快照的基准
+const uint32_t NET_NO_TICK = 0xffffffffu;
+
+// 包的第一个字节
+enum PacketType { PACKET_JOIN = 1, PACKET_WELCOME, PACKET_INPUT, PACKET_SNAPSHOT };
+
+// 加入成功的回复：分到的蛇的编号与棋盘尺寸
+struct WelcomePacket {
+    int snake;
+    int cols;
+    int rows;
+    int snakes;
+};
+
+// 客户端的输入：已应用的最新快照的 tick（没有时为 -1）与想走的方向
+struct InputPacket {
+    long long ack;
+    Direction dir;
+};
+
+int writeWelcome(const WelcomePacket& welcome, uint8_t* out);
+bool readWelcome(const uint8_t* data, int size, WelcomePacket& welcome);
+int writeInput(const InputPacket& input, uint8_t* out);
+bool readInput(const uint8_t* data, int size, InputPacket& input);
+
+// 服务器端：记录最近 NET_HISTORY_TICKS 步里每条蛇与食物的变化，按客户端确认的 tick 编码增量快照
+class SnapshotHistory {
+public:
+    SnapshotHistory();
+
+    // 从 arena 当前的局面开始记录（开局或 reset() 之后调用），之前的 tick 一律只能发完整快照
+    void start(const Arena& arena);
+    // 记录 arena 刚走完的一步；results 为这一步的结果。两步之间 spawn() 的蛇在这里记为整条重发
+    void record(const Arena& arena, const StepResult* results);
+    // 把 arena 当前局面相对 base 的增量编码进 packet；base 为 -1、太旧或不在历史里时编码完整快照并返回 true
+    bool encode(const Arena& arena, long long base, std::vector<uint8_t>& packet);
+
+private:
+    // 每条蛇每步一个字节：低两位为事件，其上两位为走的方向
+    enum Event { EVENT_NONE, EVENT_MOVED, EVENT_ATE, EVENT_RESET };
+
+    struct TickRecord {
+        std::vector<uint8_t> events;
+        std::vector<int32_t> foodAdded;
+        std::vector<int32_t> foodRemoved;
+    };
+
+    // 食物变化：格子、是否为放下（否则为吃掉）
+    struct FoodChange {
+        int32_t cell;
+        bool added;
+    };
+
+    long long firstTick;
+    std::vector<TickRecord> records;  // 按 tick % NET_HISTORY_TICKS 存放
+    std::vector<uint8_t> alive;       // 上一次记录时各蛇是否活着
+
+    // encode() 的临时数组
+    std::vector<uint8_t> dirs;
+    std::vector<FoodChange> foodChanges;
+    std::vector<int32_t> removedCells;
+    std::vector<int32_t> addedCells;
+};
+
+// 客户端：由快照还原出的棋盘，接口与 Arena 的查询部分相同，可直接交给策略和绘制
+class NetMirror {
+public:
+    NetMirror();
+
+    void setup(int cols, int rows, int snakes);
+    // 应用一个快照包：增量包的基准必须是当前的 tick，否则忽略并返回 false；
+    // 包内容与局面对不上时清空局面，tick() 回到 -1，由服务器重发完整快照
+    bool apply(const uint8_t* data, int size);
+
+    // 已应用的最新快照的 tick，还没有时为 -1
+    long long tick() const { return currentTick; }
+    int cols() const { return boardCols; }
+    int rows() const { return boardRows; }
+    int snakeCount() const { return static_cast<int>(snakes.size()); }
+
+    bool isAlive(int i) const { return snakes[i].size() > 0; }
+    int length(int i) const { return snakes[i].size(); }
+    Position head(int i) const { return segment(i, 0); }
+    Position segment(int i, int k) const {
+        int cell = snakes[i][k];
+        return {cell % boardCols, cell / boardCols};
+    }
+    // 蛇总是朝第二节指向蛇头的方向前进
+    Direction direction(int i) const { return directionTo(segment(i, 1), head(i)); }
+
+    int ownerAt(Position p) const {
+        int32_t owner = owners[p.y * boardCols + p.x];
+        return owner >= 0 ? owner : -1;
+    }
+    bool hasFood(Position p) const { return foodSlots[p.y * boardCols + p.x] >= 0; }
+    int foodCount() const { return static_cast<int>(foodCells.size()); }
+    Position food(int k) const { return {foodCells[k] % boardCols, foodCells[k] / boardCols}; }
+
+private:
+    bool decode(const uint8_t* data, int size, bool full);
+    void clear();
+    void clearSnake(int i);
+    // 去掉蛇尾；该格已归别的蛇（本步别的蛇头走了进来）时不改归属表
+    void popTail(int i);
+    void addFood(int cell);
+    void removeFood(int cell);
+
+    int boardCols;
+    int boardRows;
+    long long currentTick;
+    std::vector<ArenaBody> snakes;
+    std::vector<int32_t> owners;     // 格子 -> 蛇的编号，空格为 -1
+    std::vector<int32_t> foodCells;
+    std::vector<int32_t> foodSlots;  // 格子 -> 在 foodCells 中的下标，没有食物为 -1
+    std::vector<int32_t> cells;      // decode() 的临时数组
+};
+
+#endif // SNAKE_NET_PROTOCOL_H
@@ -0,0 +1,148 @@
+#include "NetSocket.h"
+#include <iostream>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 收发缓冲区：服务器每步要给所有客户端各发一个包，默认的缓冲区在客户端多时会丢包
+const int SOCKET_BUFFER_BYTES = 1 << 20;
+
+#ifdef _WIN32
+typedef SOCKET NativeSocket;
+typedef int AddressLength;
+
+bool startNetwork() {
+    static bool started = false;
+    if (!started) {
+        WSADATA data;
+        started = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }
+    return started;
+}
+
+int lastError() { return WSAGetLastError(); }
+#else
+typedef int NativeSocket;
+typedef socklen_t AddressLength;
+
+bool startNetwork() { return true; }
+int lastError() { return errno; }
+#endif
+
+sockaddr_in toSockaddr(const NetAddress& address) {
+    sockaddr_in result = {};
+    result.sin_family = AF_INET;
+    result.sin_addr.s_addr = htonl(address.host);
+    result.sin_port = htons(address.port);
+    return result;
+}
+
+}
+
+UdpSocket::UdpSocket() : handle(-1) {}
+
+UdpSocket::~UdpSocket() {
+    close();
+}
+
+bool UdpSocket::open(uint16_t port) {
+    close();
+    if (!startNetwork()) {
+        std::cerr << "Unable to start networking" << std::endl;
+        return false;
+    }
+    NativeSocket s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+#ifdef _WIN32
+    if (s == INVALID_SOCKET) {
+#else
+    if (s < 0) {
+#endif
+        std::cerr << "Unable to create UDP socket, error " << lastError() << std::endl;
+        return false;
+    }
+    handle = static_cast<intptr_t>(s);
+
+    int bufferBytes = SOCKET_BUFFER_BYTES;
+    setsockopt(s, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&bufferBytes), sizeof(bufferBytes));
+    setsockopt(s, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&bufferBytes), sizeof(bufferBytes));
+
+    sockaddr_in address = toSockaddr(localhost(port));
+    if (bind(s, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Unable to bind UDP port " << port << ", error " << lastError() << std::endl;
+        close();
+        return false;
+    }
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    bool ok = ioctlsocket(s, FIONBIO, &nonBlocking) == 0;
+#else
+    bool ok = fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+    if (!ok) {
+        std::cerr << "Unable to make UDP socket non-blocking, error " << lastError() << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void UdpSocket::close() {
+    if (handle == -1) {
+        return;
+    }
+#ifdef _WIN32
+    closesocket(static_cast<NativeSocket>(handle));
+#else
+    ::close(static_cast<NativeSocket>(handle));
+#endif
+    handle = -1;
+}
+
+bool UdpSocket::send(const NetAddress& to, const void* data, int size) {
+    if (handle == -1) {
+        return false;
+    }
+    sockaddr_in address = toSockaddr(to);
+    int sent = static_cast<int>(sendto(static_cast<NativeSocket>(handle), static_cast<const char*>(data), size, 0,
+                                       reinterpret_cast<const sockaddr*>(&address), sizeof(address)));
+    return sent == size;
+}
+
+int UdpSocket::receive(void* buffer, int capacity, NetAddress& from) {
+    if (handle == -1) {
+        return -1;
+    }
+    sockaddr_in address = {};
+    // Windows 上对方端口不可达会让下一次接收报错（WSAECONNRESET），与截断一样都当作没收到，继续取下一个
+    for (;;) {
+        AddressLength length = sizeof(address);
+        int received = static_cast<int>(recvfrom(static_cast<NativeSocket>(handle), static_cast<char*>(buffer),
+                                                 capacity, 0, reinterpret_cast<sockaddr*>(&address), &length));
+        if (received >= 0) {
+            from.host = ntohl(address.sin_addr.s_addr);
+            from.port = ntohs(address.sin_port);
+            return received;
+        }
+#ifdef _WIN32
+        int error = lastError();
+        if (error == WSAECONNRESET || error == WSAEMSGSIZE) {
+            continue;
+        }
+#endif
+        return -1;
+    }
+}
+
+NetAddress UdpSocket::localhost(uint16_t port) {
+    return {INADDR_LOOPBACK, port};
+}
@@ -0,0 +1,39 @@
+#ifndef SNAKE_NET_SOCKET_H
+#define SNAKE_NET_SOCKET_H
+
+#include <cstdint>
+
+// 对端地址（主机字节序）
+struct NetAddress {
+    uint32_t host;
+    uint16_t port;
+};
+
+inline bool operator==(const NetAddress& a, const NetAddress& b) { return a.host == b.host && a.port == b.port; }
+inline bool operator!=(const NetAddress& a, const NetAddress& b) { return !(a == b); }
+
+// 只在本机回环地址上收发的非阻塞 UDP 套接字（Windows 用 Winsock，其余平台用 BSD socket）
+class UdpSocket {
+public:
+    UdpSocket();
+    ~UdpSocket();
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    // 绑定 127.0.0.1:port，port 为 0 时由系统挑一个空闲端口；失败时打印原因并返回 false
+    bool open(uint16_t port);
+    void close();
+    bool isOpen() const { return handle != -1; }
+
+    bool send(const NetAddress& to, const void* data, int size);
+    // 取出一个数据报，没有数据时返回 -1；超过 capacity 的部分被丢弃
+    int receive(void* buffer, int capacity, NetAddress& from);
+
+    // 回环地址上的 port 端口
+    static NetAddress localhost(uint16_t port);
+
+private:
+    intptr_t handle;
+};
+
+#endif // SNAKE_NET_SOCKET_H
@@ -0,0 +1,299 @@
+#include "ObsEncoder.h"
+#include <algorithm>
+#include <cstring>
+
+// x86 上用 SSE2/AVX2 展开位图，按函数标注目标指令集，运行时检测 CPU 后选用；其他平台只有标量版本
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SNAKE_OBS_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// 各展开函数把第 i 位到第 count - 1 位展开到 out[i] 到 out[count - 1]；
+// 向量版本每次处理的位数整除 64 且从其整数倍开始，一组不会跨越两个字，剩余部分交给更窄的版本
+
+// 每个字只读一次：out 为字节指针时编译器无法确定写 out 不会改动 words
+void expandU8Scalar(const uint64_t* words, int i, int count, unsigned char* out) {
+    while (i < count) {
+        uint64_t w = words[i >> 6] >> (i & 63);
+        int end = std::min(count, (i | 63) + 1);
+        for (; i < end; ++i, w >>= 1) {
+            out[i] = static_cast<unsigned char>(w & 1);
+        }
+    }
+}
+
+void expandF32Scalar(const uint64_t* words, int i, int count, float* out) {
+    while (i < count) {
+        uint64_t w = words[i >> 6] >> (i & 63);
+        int end = std::min(count, (i | 63) + 1);
+        for (; i < end; ++i, w >>= 1) {
+            out[i] = static_cast<float>(w & 1);
+        }
+    }
+}
+
+#ifdef SNAKE_OBS_X86
+
+// 每次取 16 位，把每个字节复制 8 份后与各自的位掩码比较
+__attribute__((target("sse2")))
+void expandU8Sse2(const uint64_t* words, int i, int count, unsigned char* out) {
+    const __m128i select = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    const __m128i one = _mm_set1_epi8(1);
+    for (; i + 16 <= count; i += 16) {
+        int v = static_cast<int>((words[i >> 6] >> (i & 63)) & 0xffff);
+        __m128i x = _mm_cvtsi32_si128(v);
+        x = _mm_unpacklo_epi8(x, x);
+        x = _mm_unpacklo_epi16(x, x);
+        x = _mm_unpacklo_epi32(x, x);
+        x = _mm_cmpeq_epi8(_mm_and_si128(x, select), select);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_and_si128(x, one));
+    }
+    expandU8Scalar(words, i, count, out);
+}
+
+// 每次取 4 位，每位对应一个 32 位通道
+__attribute__((target("sse2")))
+void expandF32Sse2(const uint64_t* words, int i, int count, float* out) {
+    const __m128i select = _mm_setr_epi32(1, 2, 4, 8);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4) {
+        int v = static_cast<int>((words[i >> 6] >> (i & 63)) & 0xf);
+        __m128i x = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(v), select), select);
+        _mm_storeu_ps(out + i, _mm_and_ps(_mm_castsi128_ps(x), one));
+    }
+    expandF32Scalar(words, i, count, out);
+}
+
+// 每次取 32 位：广播到所有通道后按字节重排，每个字节复制 8 份
+__attribute__((target("avx2")))
+void expandU8Avx2(const uint64_t* words, int i, int count, unsigned char* out) {
+    const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                            2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i select = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                            1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    const __m256i one = _mm256_set1_epi8(1);
+    for (; i + 32 <= count; i += 32) {
+        int v = static_cast<int>(static_cast<uint32_t>(words[i >> 6] >> (i & 63)));
+        __m256i x = _mm256_shuffle_epi8(_mm256_set1_epi32(v), spread);
+        x = _mm256_cmpeq_epi8(_mm256_and_si256(x, select), select);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_and_si256(x, one));
+    }
+    // 剩余部分交给 SSE2 版本之前清掉 YMM 高半部分，避免 AVX/SSE 切换的惩罚
+    _mm256_zeroupper();
+    expandU8Sse2(words, i, count, out);
+}
+
+__attribute__((target("avx2")))
+void expandF32Avx2(const uint64_t* words, int i, int count, float* out) {
+    const __m256i select = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    for (; i + 8 <= count; i += 8) {
+        int v = static_cast<int>((words[i >> 6] >> (i & 63)) & 0xff);
+        __m256i x = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(v), select), select);
+        _mm256_storeu_ps(out + i, _mm256_and_ps(_mm256_castsi256_ps(x), one));
+    }
+    _mm256_zeroupper();
+    expandF32Sse2(words, i, count, out);
+}
+
+#endif
+
+// 从第 start 位起取 n 位（n < 64）
+uint64_t extractBits(const uint64_t* words, int start, int n) {
+    int offset = start & 63;
+    uint64_t v = words[start >> 6] >> offset;
+    if (offset + n > 64) {
+        v |= words[(start >> 6) + 1] << (64 - offset);
+    }
+    return v & ((uint64_t(1) << n) - 1);
+}
+
+// 把 n 位（n < 64）写到第 pos 位起，目标须先清零
+void putBits(uint64_t* words, int pos, uint64_t value, int n) {
+    int offset = pos & 63;
+    words[pos >> 6] |= value << offset;
+    if (offset + n > 64) {
+        words[(pos >> 6) + 1] |= value >> (64 - offset);
+    }
+}
+
+}
+
+ObsEncoder::ObsEncoder(int cols, int rows, ObsFormat format, int cropRadius, bool withAge)
+        : boardCols(cols), boardRows(rows), format(format), radius(cropRadius < 0 ? 0 : cropRadius),
+          withAge(withAge && format != OBS_BITS) {
+    if (radius > MAX_CROP_RADIUS) {
+        radius = MAX_CROP_RADIUS;
+    }
+    outWidth = radius > 0 ? 2 * radius + 1 : cols;
+    outHeight = radius > 0 ? 2 * radius + 1 : rows;
+    planeCount = this->withAge ? OBS_AGE + 1 : OBS_WALL + 1;
+    size_t cells = static_cast<size_t>(outWidth) * outHeight;
+    switch (format) {
+        case OBS_BITS: planeBytes = (cells + 63) / 64 * sizeof(uint64_t); break;
+        case OBS_U8: planeBytes = cells; break;
+        default: planeBytes = cells * sizeof(float); break;
+    }
+    useIsa(bestIsa());
+}
+
+ObsIsa ObsEncoder::bestIsa() {
+#ifdef SNAKE_OBS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return OBS_ISA_AVX2;
+    if (__builtin_cpu_supports("sse2")) return OBS_ISA_SSE2;
+#endif
+    return OBS_ISA_SCALAR;
+}
+
+const char* ObsEncoder::isaName(ObsIsa isa) {
+    switch (isa) {
+        case OBS_ISA_AVX2: return "avx2";
+        case OBS_ISA_SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+void ObsEncoder::useIsa(ObsIsa isa) {
+    if (isa > bestIsa()) {
+        isa = bestIsa();
+    }
+    activeIsa = isa;
+    expandU8 = expandU8Scalar;
+    expandF32 = expandF32Scalar;
+#ifdef SNAKE_OBS_X86
+    if (isa == OBS_ISA_AVX2) {
+        expandU8 = expandU8Avx2;
+        expandF32 = expandF32Avx2;
+    } else if (isa == OBS_ISA_SSE2) {
+        expandU8 = expandU8Sse2;
+        expandF32 = expandF32Sse2;
+    }
+#endif
+}
+
+void ObsEncoder::expand(const uint64_t* words, int count, unsigned char* out) const {
+    if (format == OBS_U8) {
+        expandU8(words, 0, count, out);
+    } else {
+        expandF32(words, 0, count, reinterpret_cast<float*>(out));
+    }
+}
+
+namespace {
+
+void setCell(ObsFormat format, unsigned char* plane, int index) {
+    switch (format) {
+        case OBS_BITS: reinterpret_cast<uint64_t*>(plane)[index >> 6] |= uint64_t(1) << (index & 63); break;
+        case OBS_U8: plane[index] = 1; break;
+        default: reinterpret_cast<float*>(plane)[index] = 1.0f; break;
+    }
+}
+
+}
+
+void ObsEncoder::encodePlanes(const uint64_t* bits, Position head, Position food, unsigned char* out) const {
+    unsigned char* body = out + OBS_BODY * planeBytes;
+    unsigned char* wall = out + OBS_WALL * planeBytes;
+    // 蛇头、食物平面只有一格非零，先清零；蛇身、墙平面下面会整个写满
+    std::memset(out + OBS_HEAD * planeBytes, 0, planeBytes * (OBS_FOOD - OBS_HEAD + 1));
+
+    if (radius == 0) {
+        std::memset(wall, 0, planeBytes);
+        if (format == OBS_BITS) {
+            std::memcpy(body, bits, planeBytes);
+        } else {
+            expand(bits, boardCols * boardRows, body);
+        }
+        setCell(format, out + OBS_HEAD * planeBytes, head.y * boardCols + head.x);
+        setCell(format, out + OBS_FOOD * planeBytes, food.y * boardCols + food.x);
+        return;
+    }
+
+    // 窗口逐行从位图中取出一段（不超过 63 位）拼成连续的位串，棋盘外的部分记在墙平面上；
+    // 按位输出时直接写入，否则拼好后整个平面一次展开
+    const int windowBits = outWidth * outHeight;
+    const int windowWords = (windowBits + 63) / 64;
+    uint64_t bodyWindow[CROP_WORDS];
+    uint64_t wallWindow[CROP_WORDS];
+    uint64_t* bodyBits = format == OBS_BITS ? reinterpret_cast<uint64_t*>(body) : bodyWindow;
+    uint64_t* wallBits = format == OBS_BITS ? reinterpret_cast<uint64_t*>(wall) : wallWindow;
+    std::fill(bodyBits, bodyBits + windowWords, 0);
+    std::fill(wallBits, wallBits + windowWords, 0);
+
+    const int left = head.x - radius;
+    const int lo = std::max(left, 0);
+    const int hi = std::min(head.x + radius + 1, boardCols);
+    const uint64_t rowMask = (uint64_t(1) << outWidth) - 1;
+    const uint64_t insideMask = ((uint64_t(1) << (hi - lo)) - 1) << (lo - left);
+    for (int cy = 0; cy < outHeight; ++cy) {
+        int y = head.y - radius + cy;
+        if (y >= 0 && y < boardRows) {
+            putBits(bodyBits, cy * outWidth, extractBits(bits, y * boardCols + lo, hi - lo) << (lo - left), outWidth);
+            putBits(wallBits, cy * outWidth, rowMask & ~insideMask, outWidth);
+        } else {
+            putBits(wallBits, cy * outWidth, rowMask, outWidth);
+        }
+    }
+    if (format != OBS_BITS) {
+        expand(bodyWindow, windowBits, body);
+        expand(wallWindow, windowBits, wall);
+    }
+
+    setCell(format, out + OBS_HEAD * planeBytes, radius * outWidth + radius);
+    int fx = food.x - left;
+    int fy = food.y - head.y + radius;
+    if (fx >= 0 && fx < outWidth && fy >= 0 && fy < outHeight) {
+        setCell(format, out + OBS_FOOD * planeBytes, fy * outWidth + fx);
+    }
+}
+
+void ObsEncoder::writeAge(Position head, Position cell, int k, int length, unsigned char* agePlane) const {
+    int index;
+    if (radius == 0) {
+        index = cell.y * boardCols + cell.x;
+    } else {
+        int x = cell.x - head.x + radius;
+        int y = cell.y - head.y + radius;
+        if (x < 0 || x >= outWidth || y < 0 || y >= outHeight) return;
+        index = y * outWidth + x;
+    }
+    int remaining = length - k;
+    if (format == OBS_U8) {
+        agePlane[index] = static_cast<unsigned char>(std::min(remaining, 255));
+    } else {
+        reinterpret_cast<float*>(agePlane)[index] = static_cast<float>(remaining) / length;
+    }
+}
+
+void ObsEncoder::encode(const SnakeEngine& engine, void* out) const {
+    unsigned char* bytes = static_cast<unsigned char*>(out);
+    const SnakeBody& snake = engine.body();
+    const Position head = snake.front();
+    encodePlanes(engine.occupancy().words(), head, engine.food(), bytes);
+    if (withAge) {
+        unsigned char* agePlane = bytes + OBS_AGE * planeBytes;
+        std::memset(agePlane, 0, planeBytes);
+        for (int k = 0; k < snake.size(); ++k) {
+            writeAge(head, snake[k], k, snake.size(), agePlane);
+        }
+    }
+}
+
+void ObsEncoder::encode(const VecEngine& envs, void* out) const {
+    unsigned char* bytes = static_cast<unsigned char*>(out);
+    for (int i = 0; i < envs.count(); ++i) {
+        unsigned char* board = bytes + i * bytesPerBoard();
+        const Position head = envs.head(i);
+        encodePlanes(envs.occupancy(i), head, envs.food(i), board);
+        if (withAge) {
+            unsigned char* agePlane = board + OBS_AGE * planeBytes;
+            std::memset(agePlane, 0, planeBytes);
+            for (int k = 0; k < envs.length(i); ++k) {
+                writeAge(head, envs.segment(i, k), k, envs.length(i), agePlane);
+            }
+        }
+    }
+}
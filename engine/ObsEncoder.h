@@ -0,0 +1,70 @@
+#ifndef SNAKE_OBS_ENCODER_H
+#define SNAKE_OBS_ENCODER_H
+
+#include "SnakeEngine.h"
+#include "VecEngine.h"
+#include <cstddef>
+
+// 观测的存储格式
+enum ObsFormat { OBS_BITS, OBS_U8, OBS_F32 };
+// 平面顺序；OBS_AGE 只在开启 withAge 时存在
+enum ObsPlane { OBS_BODY, OBS_HEAD, OBS_FOOD, OBS_WALL, OBS_AGE };
+// 展开位图所用的指令集
+enum ObsIsa { OBS_ISA_SCALAR, OBS_ISA_SSE2, OBS_ISA_AVX2 };
+
+// 把局面编码成 [plane][height][width] 的多通道平面供训练使用，直接从占用位图展开，不逐节遍历蛇身
+// OBS_BITS：每个平面按格子顺序逐位打包，平面之间按 64 位字对齐；OBS_U8/OBS_F32：每格一个 0/1 值
+// cropRadius > 0 时截取以蛇头为中心的 (2r+1)x(2r+1) 窗口，棋盘外的格子在墙平面上为 1；
+// 为 0 时输出整个棋盘，墙平面全为 0
+// withAge 只对 OBS_U8/OBS_F32 有效，追加一个平面记录每节蛇身还要几步才离开
+// （U8 截断到 255，F32 除以蛇长），需要逐节写入，开销与蛇长成正比
+class ObsEncoder {
+public:
+    static const int MAX_CROP_RADIUS = 31;
+
+    // cropRadius 超过 MAX_CROP_RADIUS 时按 MAX_CROP_RADIUS 处理
+    ObsEncoder(int cols, int rows, ObsFormat format, int cropRadius = 0, bool withAge = false);
+
+    int width() const { return outWidth; }
+    int height() const { return outHeight; }
+    int planes() const { return planeCount; }
+    size_t bytesPerBoard() const { return planeBytes * planeCount; }
+
+    // 写满 out 开始的 bytesPerBoard() 字节；out 须按 8 字节（OBS_BITS）或 4 字节（OBS_F32）对齐
+    void encode(const SnakeEngine& engine, void* out) const;
+    // 第 i 个棋盘写到 out + i * bytesPerBoard()
+    void encode(const VecEngine& envs, void* out) const;
+
+    // 当前 CPU 支持的最快指令集
+    static ObsIsa bestIsa();
+    static const char* isaName(ObsIsa isa);
+    // 默认使用 bestIsa()；指定 CPU 不支持的指令集时退回 bestIsa()（用于对比测试）
+    void useIsa(ObsIsa isa);
+    ObsIsa isa() const { return activeIsa; }
+
+private:
+    // 年龄平面之外的部分
+    void encodePlanes(const uint64_t* bits, Position head, Position food, unsigned char* out) const;
+    // 在年龄平面上写第 k 节（从蛇头数起），length 为蛇长
+    void writeAge(Position head, Position cell, int k, int length, unsigned char* agePlane) const;
+    // 把 count 位（从 words[0] 的最低位开始）展开成 count 个 0/1
+    void expand(const uint64_t* words, int count, unsigned char* out) const;
+
+    // 最大窗口的位串所占的字数
+    static const int CROP_WORDS = ((2 * MAX_CROP_RADIUS + 1) * (2 * MAX_CROP_RADIUS + 1) + 63) / 64;
+
+    int boardCols;
+    int boardRows;
+    ObsFormat format;
+    int radius;
+    bool withAge;
+    int outWidth;
+    int outHeight;
+    int planeCount;
+    size_t planeBytes;
+    ObsIsa activeIsa;
+    void (*expandU8)(const uint64_t* words, int first, int count, unsigned char* out);
+    void (*expandF32)(const uint64_t* words, int first, int count, float* out);
+};
+
+#endif // SNAKE_OBS_ENCODER_H
@@ -0,0 +1,13 @@
+#include "Policy.h"
+#include "AStarPolicy.h"
+#include "HamiltonPolicy.h"
+
+std::unique_ptr<Policy> createPolicy(const std::string& name) {
+    if (name == "astar") {
+        return std::unique_ptr<Policy>(new AStarPolicy());
+    }
+    if (name == "hamilton") {
+        return std::unique_ptr<Policy>(new HamiltonPolicy());
+    }
+    return nullptr;
+}
@@ -0,0 +1,21 @@
+#ifndef SNAKE_POLICY_H
+#define SNAKE_POLICY_H
+
+#include "SnakeEngine.h"
+#include <memory>
+#include <string>
+
+// 自动驾驶策略：每个逻辑帧根据局面给出下一步的方向，代替键盘输入
+class Policy {
+public:
+    virtual ~Policy() {}
+
+    // 新开一局（或局面被外部改动）时调用，丢弃缓存的计划
+    virtual void reset() {}
+    virtual Direction decide(const SnakeEngine& engine) = 0;
+};
+
+// 按名字创建策略（"astar"、"hamilton"），名字不认识时返回空指针
+std::unique_ptr<Policy> createPolicy(const std::string& name);
+
+#endif // SNAKE_POLICY_H
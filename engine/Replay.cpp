@@ -0,0 +1,173 @@
+#include "Replay.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace {
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void putFixed(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+// 顺序读取，越界后 ok 置为 false，之后读到的都是 0
+struct ReplayReader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    bool ok;
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= size) break;
+            uint8_t byte = data[pos++];
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) return value;
+        }
+        ok = false;
+        return 0;
+    }
+    uint64_t fixed(int bytes) {
+        if (size - pos < static_cast<size_t>(bytes)) {
+            ok = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(data[pos++]) << (i * 8);
+        }
+        return value;
+    }
+};
+
+}
+
+Replay::Replay() : boardCols(0), boardRows(0), startSeed(0), totalTicks(0), endHash(0) {}
+
+void Replay::begin(int cols, int rows, unsigned int seed) {
+    boardCols = cols;
+    boardRows = rows;
+    startSeed = seed;
+    totalTicks = 0;
+    endHash = 0;
+    turnTicks.clear();
+    turnDirs.clear();
+}
+
+void Replay::recordTurn(long long tick, Direction dir) {
+    turnTicks.push_back(tick);
+    turnDirs.push_back(static_cast<uint8_t>(dir));
+}
+
+void Replay::finish(long long ticks, uint64_t hash) {
+    totalTicks = ticks;
+    endHash = hash;
+}
+
+std::vector<uint8_t> Replay::encode() const {
+    std::vector<uint8_t> out(REPLAY_MAGIC, REPLAY_MAGIC + sizeof(REPLAY_MAGIC));
+    out.push_back(REPLAY_VERSION);
+    putVarint(out, static_cast<uint64_t>(boardCols));
+    putVarint(out, static_cast<uint64_t>(boardRows));
+    putFixed(out, startSeed, 4);
+    putVarint(out, static_cast<uint64_t>(totalTicks));
+    putVarint(out, turnTicks.size());
+
+    long long previous = 0;
+    for (size_t i = 0; i < turnTicks.size(); ++i) {
+        putVarint(out, static_cast<uint64_t>(turnTicks[i] - previous));
+        previous = turnTicks[i];
+    }
+    size_t packed = out.size();
+    out.resize(packed + (turnDirs.size() + 3) / 4, 0);
+    for (size_t i = 0; i < turnDirs.size(); ++i) {
+        out[packed + i / 4] |= static_cast<uint8_t>(turnDirs[i] << ((i % 4) * 2));
+    }
+    putFixed(out, endHash, 8);
+    return out;
+}
+
+bool Replay::decode(const uint8_t* data, size_t size) {
+    if (size < sizeof(REPLAY_MAGIC) + 1 || std::memcmp(data, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0) {
+        return false;
+    }
+    if (data[sizeof(REPLAY_MAGIC)] != REPLAY_VERSION) {
+        return false;
+    }
+    ReplayReader reader = {data, size, sizeof(REPLAY_MAGIC) + 1, true};
+    uint64_t cols = reader.varint();
+    uint64_t rows = reader.varint();
+    uint64_t seed = reader.fixed(4);
+    uint64_t ticks = reader.varint();
+    uint64_t turns = reader.varint();
+    // 每次转向至少占一个字节的步数差，以此拦住损坏文件里离谱的数量
+    if (!reader.ok || cols > MAX_BOARD_SIDE || rows > MAX_BOARD_SIDE ||
+        !validBoardSize(static_cast<int>(cols), static_cast<int>(rows)) || turns > size) {
+        return false;
+    }
+
+    begin(static_cast<int>(cols), static_cast<int>(rows), static_cast<unsigned int>(seed));
+    turnTicks.resize(turns);
+    turnDirs.resize(turns);
+    long long tick = 0;
+    for (size_t i = 0; i < turns; ++i) {
+        tick += static_cast<long long>(reader.varint());
+        turnTicks[i] = tick;
+    }
+    size_t packed = reader.pos;
+    reader.pos += (turns + 3) / 4;
+    if (!reader.ok || reader.pos > size || (turns > 0 && tick >= static_cast<long long>(ticks))) {
+        return false;
+    }
+    for (size_t i = 0; i < turns; ++i) {
+        turnDirs[i] = (data[packed + i / 4] >> ((i % 4) * 2)) & 3;
+    }
+    // 最后一个字节里没用上的位必须为 0，这些位损坏时也能发现
+    if (turns % 4 != 0 && (data[packed + turns / 4] >> ((turns % 4) * 2)) != 0) {
+        return false;
+    }
+    uint64_t hash = reader.fixed(8);
+    if (!reader.ok || reader.pos != size) {
+        return false;
+    }
+    finish(static_cast<long long>(ticks), hash);
+    return true;
+}
+
+bool Replay::save(const std::string& path) const {
+    std::vector<uint8_t> bytes = encode();
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(file);
+}
+
+bool Replay::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Unable to open replay " << path << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.size() > sizeof(REPLAY_MAGIC) && std::memcmp(bytes.data(), REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) == 0 &&
+        bytes[sizeof(REPLAY_MAGIC)] != REPLAY_VERSION) {
+        std::cerr << "Replay " << path << " has version " << static_cast<int>(bytes[sizeof(REPLAY_MAGIC)])
+                  << ", this build plays version " << static_cast<int>(REPLAY_VERSION) << std::endl;
+        return false;
+    }
+    if (!decode(bytes.data(), bytes.size())) {
+        std::cerr << "Invalid replay file " << path << std::endl;
+        return false;
+    }
+    return true;
+}
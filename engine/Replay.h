@@ -0,0 +1,87 @@
+#ifndef SNAKE_REPLAY_H
+#define SNAKE_REPLAY_H
+
+#include "SnakeEngine.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 录像文件的魔数与版本
+const char REPLAY_MAGIC[4] = {'S', 'N', 'K', 'R'};
+// 版本 2：随机数生成器换成 xoshiro256**，旧录像的食物位置无法复现
+const uint8_t REPLAY_VERSION = 2;
+
+// 录像：规则是确定的，只需开局种子和方向发生变化的步，即可逐位复现整局
+// 文件格式（整数均为小端）：
+//   魔数 | u8 版本 | varint 列数 | varint 行数 | u32 种子 | varint 总步数 | varint 转向次数
+//   | 每次转向距上一次转向的步数（varint，第一次从 0 算起）
+//   | 转向后的方向，每个 2 位、每字节 4 个 | u64 终局哈希
+class Replay {
+public:
+    Replay();
+
+    // 开始录制一局
+    void begin(int cols, int rows, unsigned int seed);
+    // 第 tick 步（从 0 数起）改用方向 dir；须按 tick 递增调用
+    void recordTurn(long long tick, Direction dir);
+    // 录制结束：总步数与结束时的 SnakeEngine::stateHash()
+    void finish(long long ticks, uint64_t hash);
+
+    std::vector<uint8_t> encode() const;
+    // 数据不完整或格式不符时返回 false
+    bool decode(const uint8_t* data, size_t size);
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    int cols() const { return boardCols; }
+    int rows() const { return boardRows; }
+    unsigned int seed() const { return startSeed; }
+    long long ticks() const { return totalTicks; }
+    uint64_t finalHash() const { return endHash; }
+    size_t turnCount() const { return turnTicks.size(); }
+    long long turnTick(size_t i) const { return turnTicks[i]; }
+    Direction turnDirection(size_t i) const { return static_cast<Direction>(turnDirs[i]); }
+
+private:
+    int boardCols;
+    int boardRows;
+    unsigned int startSeed;
+    long long totalTicks;
+    uint64_t endHash;
+    std::vector<long long> turnTicks;
+    std::vector<uint8_t> turnDirs;
+};
+
+// 回放：按录像给出每一步的动作，可逐步驱动带画面的游戏，也可一口气跑完
+class ReplayPlayer {
+public:
+    explicit ReplayPlayer(const Replay& replay) : replay(replay), cursor(0) {}
+
+    // 以录像的种子重开 engine
+    void start(SnakeEngine& engine) {
+        cursor = 0;
+        engine.reset(replay.seed());
+    }
+    bool done(const SnakeEngine& engine) const { return engine.isOver() || engine.ticks() >= replay.ticks(); }
+    // 下一步的动作：这一步有转向就用录下的方向，否则保持原方向
+    Direction nextAction(const SnakeEngine& engine) {
+        if (cursor < replay.turnCount() && replay.turnTick(cursor) == engine.ticks()) {
+            return replay.turnDirection(cursor++);
+        }
+        return engine.direction();
+    }
+    // 无画面、不限速地跑完剩余的步数
+    void runToEnd(SnakeEngine& engine) {
+        while (!done(engine)) {
+            engine.step(nextAction(engine));
+        }
+    }
+    // 结束时的局面与录制时一致
+    bool matches(const SnakeEngine& engine) const { return engine.stateHash() == replay.finalHash(); }
+
+private:
+    const Replay& replay;
+    size_t cursor;
+};
+
+#endif // SNAKE_REPLAY_H
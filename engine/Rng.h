@@ -0,0 +1,81 @@
+#ifndef SNAKE_RNG_H
+#define SNAKE_RNG_H
+
+#include <cstdint>
+
+// xoshiro256** 随机数生成器：状态只有 32 字节，每局（每个棋盘）各持一份，互不共享
+// 种子经 splitmix64 展开成初始状态，相邻的种子也能得到互不相关的序列
+// jump() 一次跳过 2^128 个输出，split() 借此从一个主种子分出任意多条互不重叠的流
+class Rng {
+public:
+    explicit Rng(uint64_t seed = 0) { this->seed(seed); }
+
+    void seed(uint64_t value) {
+        for (int i = 0; i < 4; ++i) {
+            value += 0x9e3779b97f4a7c15ull;
+            uint64_t z = value;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            s[i] = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() {
+        const uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // [0, n) 内均匀分布的整数（Lemire 的乘法取高位法，仅在极少数情况下重抽以消除偏差）
+    uint32_t bounded(uint32_t n) {
+        uint64_t m = (next() >> 32) * n;
+        uint32_t low = static_cast<uint32_t>(m);
+        if (low < n) {
+            const uint32_t threshold = (0u - n) % n;
+            while (low < threshold) {
+                m = (next() >> 32) * n;
+                low = static_cast<uint32_t>(m);
+            }
+        }
+        return static_cast<uint32_t>(m >> 32);
+    }
+
+    // 相当于调用 2^128 次 next()
+    void jump() {
+        static const uint64_t JUMP[4] = {0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull,
+                                         0x39abdc4529b1661cull};
+        uint64_t t[4] = {0, 0, 0, 0};
+        for (int i = 0; i < 4; ++i) {
+            for (int b = 0; b < 64; ++b) {
+                if (JUMP[i] & (uint64_t(1) << b)) {
+                    for (int k = 0; k < 4; ++k) t[k] ^= s[k];
+                }
+                next();
+            }
+        }
+        for (int k = 0; k < 4; ++k) s[k] = t[k];
+    }
+
+    // 返回一条从当前位置开始的流，自身跳到 2^128 之后，两者此后永不重叠
+    Rng split() {
+        Rng child = *this;
+        jump();
+        return child;
+    }
+
+    // 内部状态，用于哈希与比较
+    uint64_t state(int i) const { return s[i]; }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t s[4];
+};
+
+#endif // SNAKE_RNG_H
@@ -0,0 +1,126 @@
+#include "SnakeEngine.h"
+#include "Trace.h"
+
+SnakeEngine::SnakeEngine(int cols, int rows, unsigned int seed)
+        : boardCols(cols), boardRows(rows), snake(cols * rows), occupied(cols, rows), bodySlots(cols, rows),
+          freeCells(cols, rows), foodPos({0, 0}), dir(RIGHT), over(false), tickCount(0) {
+    reset(seed);
+}
+
+void SnakeEngine::reset(unsigned int seed) {
+    // 初始化蛇
+    std::vector<Position> body;
+    body.push_back({boardCols / 2, boardRows / 2});
+    body.push_back({boardCols / 2 - 1, boardRows / 2});
+    body.push_back({boardCols / 2 - 2, boardRows / 2});
+    reset(seed, body, RIGHT);
+}
+
+void SnakeEngine::reset(unsigned int seed, const std::vector<Position>& body, Direction startDir) {
+    rng.seed(seed);
+    snake.clear();
+    occupied.reset();
+    freeCells.reset();
+    dir = startDir;
+    over = false;
+    tickCount = 0;
+
+    for (size_t i = body.size(); i-- > 0;) {
+        snake.pushFront(body[i]);
+        bodySlots.set(body[i], snake.headSlot());
+    }
+    for (size_t i = 0; i < body.size(); ++i) {
+        occupied.set(body[i].x, body[i].y);
+        freeCells.occupy(body[i].x, body[i].y);
+    }
+
+    // 生成食物
+    generateFood();
+}
+
+StepResult SnakeEngine::step(Direction action) {
+    if (over) {
+        return STEP_DIED;
+    }
+    if (action != opposite(dir)) {
+        dir = action;
+    }
+    ++tickCount;
+
+    // 移动蛇
+    Position newHead = advance(snake.front(), dir);
+
+    // 检查是否吃到食物
+    bool grow = newHead == foodPos;
+
+    // 检查碰撞；不增长时蛇尾会让出格子，蛇头可以紧跟着走进去
+    const Position tail = snake.back();
+    if (checkCollision(newHead) && (grow || newHead != tail)) {
+        over = true;
+        return STEP_DIED;
+    }
+
+    if (!grow) {
+        occupied.clear(tail.x, tail.y);
+        freeCells.release(tail.x, tail.y);
+        snake.popBack();
+    }
+
+    // 更新蛇的位置
+    snake.pushFront(newHead);
+    bodySlots.set(newHead, snake.headSlot());
+    occupied.set(newHead.x, newHead.y);
+    freeCells.occupy(newHead.x, newHead.y);
+    if (!grow) {
+        return STEP_MOVED;
+    }
+    // 没有空格可放食物说明蛇已占满棋盘
+    if (!generateFood()) {
+        over = true;
+        return STEP_WON;
+    }
+    return STEP_ATE;
+}
+
+uint64_t SnakeEngine::stateHash() const {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (value >> (i * 8)) & 0xff;
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(static_cast<uint64_t>(boardCols));
+    mix(static_cast<uint64_t>(boardRows));
+    mix(static_cast<uint64_t>(tickCount));
+    mix(static_cast<uint64_t>(dir));
+    mix(over ? 1 : 0);
+    mix(static_cast<uint64_t>(foodPos.y * boardCols + foodPos.x));
+    mix(static_cast<uint64_t>(snake.size()));
+    for (int i = 0; i < snake.size(); ++i) {
+        mix(static_cast<uint64_t>(snake[i].y * boardCols + snake[i].x));
+    }
+    for (int i = 0; i < 4; ++i) {
+        mix(rng.state(i));
+    }
+    return hash;
+}
+
+bool SnakeEngine::generateFood() {
+    SNAKE_TRACE_ZONE("generateFood");
+    // 只在空格中均匀挑选，食物不会落在蛇身上
+    if (freeCells.empty()) {
+        return false;
+    }
+    foodPos = freeCells.at(static_cast<int>(rng.bounded(static_cast<uint32_t>(freeCells.size()))));
+    return true;
+}
+
+bool SnakeEngine::checkCollision(const Position& newHead) const {
+    SNAKE_TRACE_ZONE("checkCollision");
+    // 撞墙和撞到自己都只需查一次占用位图
+    if (!occupied.inside(newHead.x, newHead.y)) {
+        return true;
+    }
+    return occupied.test(newHead.x, newHead.y);
+}
@@ -0,0 +1,68 @@
+#ifndef SNAKE_ENGINE_H
+#define SNAKE_ENGINE_H
+
+#include "Board.h"
+#include "Rng.h"
+
+// 棋盘尺寸的范围：开局的三格蛇横放在中间一行，至少要 4 列；
+// 每边的上限为 4096 格（4096x4096 时规则引擎约占 350 MB），格子总数也不会超出 int
+const int MIN_BOARD_COLS = 4;
+const int MIN_BOARD_ROWS = 1;
+const int MAX_BOARD_SIDE = 4096;
+
+inline bool validBoardSize(int cols, int rows) {
+    return cols >= MIN_BOARD_COLS && rows >= MIN_BOARD_ROWS && cols <= MAX_BOARD_SIDE && rows <= MAX_BOARD_SIDE;
+}
+
+// 单步结果
+enum StepResult { STEP_MOVED, STEP_ATE, STEP_DIED, STEP_WON };
+
+// 不依赖 SDL 的游戏规则：移动、吃食物、碰撞
+// 前端只负责把输入转换为方向并调用 step()，再按 body()/food() 绘制
+class SnakeEngine {
+public:
+    SnakeEngine(int cols, int rows, unsigned int seed);
+
+    // 重新开局：三格长的蛇位于棋盘中央，朝右
+    void reset(unsigned int seed);
+    // 以指定的蛇身开局（从蛇头到蛇尾，须为互不重叠的相邻格子），dir 为上一步的方向
+    void reset(unsigned int seed, const std::vector<Position>& body, Direction dir);
+    // 推进一步；与当前方向相反的 action 会被忽略
+    StepResult step(Direction action);
+
+    int cols() const { return boardCols; }
+    int rows() const { return boardRows; }
+    const SnakeBody& body() const { return snake; }
+    const OccupancyGrid& occupancy() const { return occupied; }
+    const CellSlotMap& slots() const { return bodySlots; }
+    // 占据该格的是从蛇头数起的第几节，没有蛇身时返回 -1
+    int segmentAt(Position cell) const {
+        if (!occupied.inside(cell.x, cell.y) || !occupied.test(cell.x, cell.y)) return -1;
+        return snake.indexOfSlot(bodySlots.get(cell));
+    }
+    Position food() const { return foodPos; }
+    // 上一步实际采用的方向
+    Direction direction() const { return dir; }
+    bool isOver() const { return over; }
+    long long ticks() const { return tickCount; }
+    // 整个局面（含随机数状态）的 64 位 FNV-1a 哈希，用于校验录像能否逐位复现
+    uint64_t stateHash() const;
+
+private:
+    bool generateFood();
+    bool checkCollision(const Position& newHead) const;
+
+    int boardCols;
+    int boardRows;
+    SnakeBody snake;
+    OccupancyGrid occupied;
+    CellSlotMap bodySlots;
+    FreeCellSet freeCells;
+    Position foodPos;
+    Direction dir;
+    bool over;
+    long long tickCount;
+    Rng rng;
+};
+
+#endif // SNAKE_ENGINE_H
@@ -0,0 +1,360 @@
+#include "TiledArena.h"
+#include "Trace.h"
+#include <algorithm>
+
+namespace {
+
+const int FOOD_ATTEMPTS = 64;
+const int SPAWN_ATTEMPTS = 64;
+// 认领表至少的槽数，装填率不超过一半
+const int MIN_CLAIM_SLOTS = 16;
+
+}
+
+const int32_t TiledArena::FREE;
+const int32_t TiledArena::FOOD;
+
+TiledArena::TiledArena(int cols, int rows, int snakes, int foods, unsigned int seed, int threads, int tileSize)
+        : boardCols(cols), boardRows(rows), tileSize(std::max(tileSize, 1)), aliveSnakes(0),
+          tickCount(0), snakes(snakes), owners(static_cast<size_t>(cols) * rows, FREE), nextCell(snakes),
+          grows(snakes), headOn(snakes), stepActions(nullptr), stepResults(nullptr), threads(std::max(threads, 1)),
+          currentPhase(PHASE_PLAN), generation(0), pending(0), stopping(false) {
+    tilesX = (cols + this->tileSize - 1) / this->tileSize;
+    tilesY = (rows + this->tileSize - 1) / this->tileSize;
+    tiles.resize(static_cast<size_t>(tilesX) * tilesY);
+    // 食物按面积分给各图块：第 t 块分到前 t + 1 块应得总数与前 t 块应得总数之差
+    const long long cells = static_cast<long long>(cols) * rows;
+    long long area = 0;
+    for (int t = 0; t < tileCount(); ++t) {
+        Tile& tile = tiles[t];
+        tile.x0 = t % tilesX * this->tileSize;
+        tile.y0 = t / tilesX * this->tileSize;
+        tile.x1 = std::min(tile.x0 + this->tileSize, cols);
+        tile.y1 = std::min(tile.y0 + this->tileSize, rows);
+        long long before = foods * area / cells;
+        area += static_cast<long long>(tile.x1 - tile.x0) * (tile.y1 - tile.y0);
+        tile.targetFoods = static_cast<int>(foods * area / cells - before);
+    }
+    reset(seed);
+    for (int w = 1; w < this->threads; ++w) {
+        workers.emplace_back(&TiledArena::workerLoop, this, w);
+    }
+}
+
+TiledArena::~TiledArena() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void TiledArena::reset(unsigned int seed) {
+    // 放蛇用一条流，每个图块再各分一条补食物
+    Rng streams(seed);
+    rng = streams.split();
+    std::fill(owners.begin(), owners.end(), FREE);
+    for (Tile& tile : tiles) {
+        tile.snakes.clear();
+        for (std::vector<Move>& box : tile.outbox) box.clear();
+        tile.foods = 0;
+        tile.rng = streams.split();
+    }
+    for (TiledSnake& s : snakes) {
+        s.body.clear();
+        s.dir = RIGHT;
+        s.alive = false;
+    }
+    aliveSnakes = 0;
+    tickCount = 0;
+    for (int i = 0; i < snakeCount(); ++i) {
+        spawn(i);
+    }
+    for (Tile& tile : tiles) {
+        while (tile.foods < tile.targetFoods && placeFood(tile)) {
+        }
+    }
+}
+
+bool TiledArena::spawn(int i) {
+    TiledSnake& s = snakes[i];
+    if (s.alive || boardCols < 3) {
+        return false;
+    }
+    const uint32_t cells = static_cast<uint32_t>(owners.size());
+    for (int attempt = 0; attempt < SPAWN_ATTEMPTS; ++attempt) {
+        int head = static_cast<int>(rng.bounded(cells));
+        Direction dir = rng.bounded(2) ? RIGHT : LEFT;
+        int x = head % boardCols;
+        int step = dir == RIGHT ? -1 : 1;
+        if (x + 2 * step < 0 || x + 2 * step >= boardCols) {
+            continue;
+        }
+        if (owners[head] != FREE || owners[head + step] != FREE || owners[head + 2 * step] != FREE) {
+            continue;
+        }
+        s.body.clear();
+        for (int k = 2; k >= 0; --k) {
+            s.body.pushFront(head + k * step);
+            owners[head + k * step] = i;
+        }
+        s.dir = static_cast<uint8_t>(dir);
+        s.alive = true;
+        tiles[tileOf(head)].snakes.push_back(i);
+        ++aliveSnakes;
+        return true;
+    }
+    return false;
+}
+
+int TiledArena::foodCount() const {
+    int count = 0;
+    for (const Tile& tile : tiles) count += tile.foods;
+    return count;
+}
+
+bool TiledArena::placeFood(Tile& tile) {
+    const uint32_t width = static_cast<uint32_t>(tile.x1 - tile.x0);
+    const uint32_t height = static_cast<uint32_t>(tile.y1 - tile.y0);
+    for (int attempt = 0; attempt < FOOD_ATTEMPTS; ++attempt) {
+        size_t y = tile.y0 + tile.rng.bounded(height);
+        size_t x = tile.x0 + tile.rng.bounded(width);
+        int32_t& owner = owners[y * boardCols + x];
+        if (owner == FREE) {
+            owner = FOOD;
+            ++tile.foods;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TiledArena::kill(int i) {
+    TiledSnake& s = snakes[i];
+    for (int k = 0; k < s.body.size(); ++k) {
+        owners[s.body[k]] = FREE;
+    }
+    s.body.clear();
+    s.alive = false;
+}
+
+template <class Visit>
+void TiledArena::forEachIncoming(int t, Visit visit) {
+    const int tx = t % tilesX;
+    const int ty = t / tilesX;
+    for (const Move& m : tiles[t].outbox[OUT_SELF]) visit(m);
+    if (ty > 0) {
+        for (const Move& m : tiles[t - tilesX].outbox[OUT_DOWN]) visit(m);
+    }
+    if (ty + 1 < tilesY) {
+        for (const Move& m : tiles[t + tilesX].outbox[OUT_UP]) visit(m);
+    }
+    if (tx > 0) {
+        for (const Move& m : tiles[t - 1].outbox[OUT_RIGHT]) visit(m);
+    }
+    if (tx + 1 < tilesX) {
+        for (const Move& m : tiles[t + 1].outbox[OUT_LEFT]) visit(m);
+    }
+}
+
+// 第一阶段：算出蛇头要进入的格子，按目标图块写进发件箱（只读归属表）
+void TiledArena::plan(int t) {
+    Tile& tile = tiles[t];
+    for (std::vector<Move>& box : tile.outbox) box.clear();
+    for (int i : tile.snakes) {
+        TiledSnake& s = snakes[i];
+        uint8_t a = static_cast<uint8_t>(stepActions[i]);
+        if (a != (s.dir ^ 1)) {
+            s.dir = a;
+        }
+        Position next = advance(head(i), static_cast<Direction>(s.dir));
+        bool inside = next.x >= 0 && next.x < boardCols && next.y >= 0 && next.y < boardRows;
+        int cell = inside ? next.y * boardCols + next.x : -1;
+        nextCell[i] = cell;
+        grows[i] = inside && owners[cell] == FOOD;
+        headOn[i] = 0;
+        if (inside) {
+            // 方向枚举与发件箱的前四格一一对应
+            tile.outbox[tileOf(cell) == t ? OUT_SELF : static_cast<Outbox>(s.dir)].push_back({i, cell});
+        }
+    }
+}
+
+// 第二阶段：本图块的蛇收回蛇尾（蛇尾可能在别的图块，但每格只属于一条蛇）；
+// 认领进入本图块的蛇头，同一格被认领两次即为相撞
+void TiledArena::claim(int t) {
+    Tile& tile = tiles[t];
+    for (int i : tile.snakes) {
+        if (!grows[i]) {
+            owners[snakes[i].body.back()] = FREE;
+            snakes[i].body.popBack();
+        }
+    }
+
+    size_t incoming = 0;
+    forEachIncoming(t, [&incoming](const Move&) { ++incoming; });
+    size_t slots = MIN_CLAIM_SLOTS;
+    while (slots < incoming * 2) slots *= 2;
+    tile.claimCells.assign(slots, -1);
+    tile.claimSnakes.resize(slots);
+    const size_t mask = slots - 1;
+    forEachIncoming(t, [&](const Move& m) {
+        size_t h = (static_cast<uint32_t>(m.cell) * 2654435761u) & mask;
+        while (tile.claimCells[h] != -1 && tile.claimCells[h] != m.cell) {
+            h = (h + 1) & mask;
+        }
+        if (tile.claimCells[h] == m.cell) {
+            headOn[m.snake] = 1;
+            headOn[tile.claimSnakes[h]] = 1;
+        } else {
+            tile.claimCells[h] = m.cell;
+            tile.claimSnakes[h] = m.snake;
+        }
+    });
+}
+
+// 第三阶段：所有蛇尾都已收回，判定本图块的蛇是否死亡（只读归属表）
+void TiledArena::decide(int t) {
+    for (int i : tiles[t].snakes) {
+        int cell = nextCell[i];
+        if (cell < 0 || owners[cell] >= 0 || headOn[i]) {
+            stepResults[i] = STEP_DIED;
+        } else {
+            stepResults[i] = grows[i] ? STEP_ATE : STEP_MOVED;
+        }
+    }
+}
+
+// 第四阶段：移除死去的蛇，其余的蛇前进一格；各线程写的格子互不相同
+void TiledArena::apply(int t) {
+    for (int i : tiles[t].snakes) {
+        if (stepResults[i] == STEP_DIED) {
+            kill(i);
+        } else {
+            snakes[i].body.pushFront(nextCell[i]);
+            owners[nextCell[i]] = i;
+        }
+    }
+}
+
+// 第五阶段：按固定顺序重建本图块的蛇名单，扣掉被吃的食物后补足
+void TiledArena::settle(int t) {
+    Tile& tile = tiles[t];
+    tile.arrivals.clear();
+    int eaten = 0;
+    forEachIncoming(t, [&](const Move& m) {
+        if (stepResults[m.snake] != STEP_DIED) {
+            tile.arrivals.push_back(m.snake);
+            eaten += grows[m.snake];
+        }
+    });
+    tile.snakes.swap(tile.arrivals);
+    tile.foods -= eaten;
+    while (tile.foods < tile.targetFoods && placeFood(tile)) {
+    }
+}
+
+void TiledArena::runTiles(Phase phase, int worker) {
+    for (int t = worker; t < tileCount(); t += threads) {
+        switch (phase) {
+            case PHASE_PLAN: plan(t); break;
+            case PHASE_CLAIM: claim(t); break;
+            case PHASE_DECIDE: decide(t); break;
+            case PHASE_APPLY: apply(t); break;
+            case PHASE_SETTLE: settle(t); break;
+        }
+    }
+}
+
+void TiledArena::runPhase(Phase phase) {
+    if (threads == 1) {
+        runTiles(phase, 0);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        currentPhase = phase;
+        pending = threads - 1;
+        ++generation;
+    }
+    wake.notify_all();
+    runTiles(phase, 0);
+    std::unique_lock<std::mutex> lock(poolMutex);
+    finished.wait(lock, [this] { return pending == 0; });
+}
+
+void TiledArena::workerLoop(int worker) {
+    unsigned int seen = 0;
+    for (;;) {
+        Phase phase;
+        {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            phase = currentPhase;
+        }
+        runTiles(phase, worker);
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            if (--pending == 0) finished.notify_one();
+        }
+    }
+}
+
+void TiledArena::step(const Direction* actions, StepResult* results) {
+    SNAKE_TRACE_ZONE("TiledArena::step");
+    stepActions = actions;
+    stepResults = results;
+    for (int i = 0; i < snakeCount(); ++i) {
+        if (!snakes[i].alive) results[i] = STEP_DIED;
+    }
+    runPhase(PHASE_PLAN);
+    runPhase(PHASE_CLAIM);
+    runPhase(PHASE_DECIDE);
+    runPhase(PHASE_APPLY);
+    runPhase(PHASE_SETTLE);
+
+    aliveSnakes = 0;
+    for (const Tile& tile : tiles) {
+        aliveSnakes += static_cast<int>(tile.snakes.size());
+    }
+    ++tickCount;
+}
+
+uint64_t TiledArena::stateHash() const {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (value >> (i * 8)) & 0xff;
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(static_cast<uint64_t>(boardCols));
+    mix(static_cast<uint64_t>(boardRows));
+    mix(static_cast<uint64_t>(tickCount));
+    for (const TiledSnake& s : snakes) {
+        mix(s.alive ? 1 : 0);
+        mix(s.dir);
+        mix(static_cast<uint64_t>(s.body.size()));
+        for (int k = 0; k < s.body.size(); ++k) {
+            mix(static_cast<uint64_t>(s.body[k]));
+        }
+    }
+    for (size_t cell = 0; cell < owners.size(); ++cell) {
+        if (owners[cell] == FOOD) mix(cell);
+    }
+    for (int i = 0; i < 4; ++i) {
+        mix(rng.state(i));
+    }
+    for (const Tile& tile : tiles) {
+        mix(static_cast<uint64_t>(tile.foods));
+        for (int i = 0; i < 4; ++i) {
+            mix(tile.rng.state(i));
+        }
+    }
+    return hash;
+}
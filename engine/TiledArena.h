@@ -0,0 +1,139 @@
+#ifndef SNAKE_TILED_ARENA_H
+#define SNAKE_TILED_ARENA_H
+
+#include "Arena.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 超大棋盘的多蛇对战，规则与 Arena 相同，按图块多线程推进
+// 棋盘划分成 tileSize x tileSize 的图块，每条蛇归蛇头所在的图块，各图块由工作线程并行处理；
+// 每一步分五个阶段，阶段之间所有线程同步一次。跨图块的移动写进来源图块按方向分开的发件箱，
+// 目标图块按固定顺序读取；食物由各图块用自己的随机数流补充。
+// 图块划分只取决于 tileSize，与线程数无关，所以任何线程数下结果逐位相同
+class TiledArena {
+public:
+    static const int32_t FREE = -1;
+    static const int32_t FOOD = -2;
+
+    // threads 为参与推进的线程数（含调用 step() 的线程）；foods 按面积分给各图块
+    TiledArena(int cols, int rows, int snakes, int foods, unsigned int seed, int threads, int tileSize = 256);
+    ~TiledArena();
+
+    void reset(unsigned int seed);
+    // 与 Arena::step() 相同
+    void step(const Direction* actions, StepResult* results);
+    // 与 Arena::spawn() 相同；只能在两次 step() 之间调用
+    bool spawn(int i);
+
+    int cols() const { return boardCols; }
+    int rows() const { return boardRows; }
+    int snakeCount() const { return static_cast<int>(snakes.size()); }
+    int aliveCount() const { return aliveSnakes; }
+    long long ticks() const { return tickCount; }
+    int threadCount() const { return threads; }
+    int tileCount() const { return static_cast<int>(tiles.size()); }
+
+    bool isAlive(int i) const { return snakes[i].alive; }
+    int length(int i) const { return snakes[i].body.size(); }
+    Direction direction(int i) const { return static_cast<Direction>(snakes[i].dir); }
+    Position head(int i) const { return segment(i, 0); }
+    Position segment(int i, int k) const {
+        int cell = snakes[i].body[k];
+        return {cell % boardCols, cell / boardCols};
+    }
+    int ownerAt(Position p) const {
+        int32_t owner = owners[static_cast<size_t>(p.y) * boardCols + p.x];
+        return owner >= 0 ? owner : -1;
+    }
+    bool hasFood(Position p) const { return owners[static_cast<size_t>(p.y) * boardCols + p.x] == FOOD; }
+    int foodCount() const;
+
+    // 整个局面（含各随机数流）的 64 位 FNV-1a 哈希；要扫描整张棋盘找食物，开销与格子数成正比
+    uint64_t stateHash() const;
+
+private:
+    struct TiledSnake {
+        ArenaBody body;
+        uint8_t dir;
+        bool alive;
+    };
+
+    struct Move {
+        int32_t snake;
+        int32_t cell;
+    };
+
+    // 发件箱按移动方向分开，留在本图块内的移动单独一格
+    enum Outbox { OUT_UP, OUT_DOWN, OUT_LEFT, OUT_RIGHT, OUT_SELF, OUTBOX_COUNT };
+
+    struct Tile {
+        int x0, y0, x1, y1;
+        // 归本图块的蛇，按固定顺序排列；arrivals 为下一步的名单，两者每步交换
+        std::vector<int32_t> snakes;
+        std::vector<int32_t> arrivals;
+        std::vector<Move> outbox[OUTBOX_COUNT];
+        // 本步进入本图块的蛇头认领表（开放寻址，格子 -> 蛇），判定蛇头相撞
+        std::vector<int32_t> claimCells;
+        std::vector<int32_t> claimSnakes;
+        int foods;
+        int targetFoods;
+        Rng rng;
+    };
+
+    enum Phase { PHASE_PLAN, PHASE_CLAIM, PHASE_DECIDE, PHASE_APPLY, PHASE_SETTLE };
+
+    int tileOf(int cell) const {
+        return (cell / boardCols) / tileSize * tilesX + (cell % boardCols) / tileSize;
+    }
+    // 按固定顺序列出本步进入图块 t 的所有移动：本图块内、上、下、左、右四个邻居的发件箱
+    template <class Visit>
+    void forEachIncoming(int t, Visit visit);
+
+    // 在所有线程上执行一个阶段并等待完成，调用线程也参与
+    void runPhase(Phase phase);
+    void workerLoop(int worker);
+    void runTiles(Phase phase, int worker);
+
+    void plan(int t);
+    void claim(int t);
+    void decide(int t);
+    void apply(int t);
+    void settle(int t);
+    void kill(int i);
+    // 在图块内随机挑空格放食物，最多试 FOOD_ATTEMPTS 次
+    bool placeFood(Tile& tile);
+
+    int boardCols;
+    int boardRows;
+    int tileSize;
+    int tilesX;
+    int tilesY;
+    int aliveSnakes;
+    long long tickCount;
+    Rng rng;
+    std::vector<TiledSnake> snakes;
+    std::vector<int32_t> owners;
+    std::vector<Tile> tiles;
+
+    // 每条蛇一个元素，由蛇所在的图块写
+    std::vector<int32_t> nextCell;
+    std::vector<uint8_t> grows;
+    std::vector<uint8_t> headOn;
+    const Direction* stepActions;
+    StepResult* stepResults;
+
+    // 线程池：generation 每换一个阶段加一，pending 为尚未完成当前阶段的工作线程数
+    int threads;
+    std::vector<std::thread> workers;
+    std::mutex poolMutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    Phase currentPhase;
+    unsigned int generation;
+    int pending;
+    bool stopping;
+};
+
+#endif // SNAKE_TILED_ARENA_H
@@ -0,0 +1,115 @@
+#include "Trace.h"
+
+#ifdef SNAKE_TRACE
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+// 每个线程的环形缓冲区容量，写满后覆盖最旧的记录
+static const uint64_t BUFFER_SIZE = 1 << 16;
+
+// 单条记录；seq 为写入序号加一，写入过程中为 0，读取方据此丢弃正在被覆盖的记录
+struct Event {
+    std::atomic<uint64_t> seq;
+    std::atomic<const char*> name;
+    std::atomic<uint64_t> begin;
+    std::atomic<uint64_t> end;
+};
+
+// 只有所属线程写入，导出时其他线程只读
+struct ThreadBuffer {
+    std::vector<Event> events;
+    std::atomic<uint64_t> written;
+    std::atomic<const char*> threadName;
+    int tid;
+
+    explicit ThreadBuffer(int tid) : events(BUFFER_SIZE), written(0), threadName(nullptr), tid(tid) {}
+};
+
+// 缓冲区在线程第一次记录时注册，之后一直保留到进程结束，线程退出后仍可导出
+static std::mutex registryMutex;
+static std::vector<ThreadBuffer*> registry;
+
+static ThreadBuffer& localBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffer = new ThreadBuffer(static_cast<int>(registry.size()) + 1);
+        registry.push_back(buffer);
+    }
+    return *buffer;
+}
+
+uint64_t traceNow() {
+    static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count());
+}
+
+void traceRecord(const char* name, uint64_t begin, uint64_t end) {
+    ThreadBuffer& buffer = localBuffer();
+    uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    Event& event = buffer.events[index & (BUFFER_SIZE - 1)];
+    event.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name.store(name, std::memory_order_relaxed);
+    event.begin.store(begin, std::memory_order_relaxed);
+    event.end.store(end, std::memory_order_relaxed);
+    event.seq.store(index + 1, std::memory_order_release);
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void traceSetThreadName(const char* name) {
+    localBuffer().threadName.store(name, std::memory_order_release);
+}
+
+bool writeChromeTrace(const std::string& path) {
+    std::vector<ThreadBuffer*> buffers;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffers = registry;
+    }
+
+    std::ofstream file(path.c_str());
+    if (!file) {
+        return false;
+    }
+    // 记录以纳秒为单位，JSON 中的时间以微秒为单位
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (size_t b = 0; b < buffers.size(); ++b) {
+        ThreadBuffer& buffer = *buffers[b];
+        const char* threadName = buffer.threadName.load(std::memory_order_acquire);
+        if (threadName != nullptr) {
+            file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.tid
+                 << ",\"args\":{\"name\":\"" << threadName << "\"}}";
+            first = false;
+        }
+
+        uint64_t written = buffer.written.load(std::memory_order_acquire);
+        uint64_t oldest = written > BUFFER_SIZE ? written - BUFFER_SIZE : 0;
+        for (uint64_t index = oldest; index < written; ++index) {
+            Event& event = buffer.events[index & (BUFFER_SIZE - 1)];
+            uint64_t seq = event.seq.load(std::memory_order_acquire);
+            const char* name = event.name.load(std::memory_order_relaxed);
+            uint64_t begin = event.begin.load(std::memory_order_relaxed);
+            uint64_t end = event.end.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq != index + 1 || event.seq.load(std::memory_order_relaxed) != seq) {
+                continue;  // 正在被覆盖
+            }
+            file << (first ? "" : ",\n") << "{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                 << buffer.tid << ",\"ts\":" << begin / 1000.0 << ",\"dur\":" << (end - begin) / 1000.0 << "}";
+            first = false;
+        }
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+#endif // SNAKE_TRACE
@@ -0,0 +1,46 @@
+#ifndef SNAKE_TRACE_H
+#define SNAKE_TRACE_H
+
+// 轻量级时间线追踪：SNAKE_TRACE_ZONE("name") 记录所在作用域的开始与结束，
+// SNAKE_TRACE_WRITE(path) 把全部线程的记录写成 Chrome trace-event JSON（chrome://tracing 或 Perfetto 打开）
+// 未定义 SNAKE_TRACE 时这些宏全部展开为空，不产生任何代码
+
+#ifdef SNAKE_TRACE
+
+#include <cstdint>
+#include <string>
+
+// 当前时间（纳秒）
+uint64_t traceNow();
+// 记录一个已结束的区间；只写本线程的缓冲区，不加锁
+void traceRecord(const char* name, uint64_t begin, uint64_t end);
+// 给当前线程命名，显示在时间线上
+void traceSetThreadName(const char* name);
+// 写出 JSON，可在运行中随时调用
+bool writeChromeTrace(const std::string& path);
+
+class TraceZone {
+public:
+    explicit TraceZone(const char* name) : name(name), begin(traceNow()) {}
+    ~TraceZone() { traceRecord(name, begin, traceNow()); }
+
+private:
+    const char* name;
+    uint64_t begin;
+};
+
+#define SNAKE_TRACE_CONCAT_INNER(a, b) a##b
+#define SNAKE_TRACE_CONCAT(a, b) SNAKE_TRACE_CONCAT_INNER(a, b)
+#define SNAKE_TRACE_ZONE(name) TraceZone SNAKE_TRACE_CONCAT(traceZone, __LINE__)(name)
+#define SNAKE_TRACE_THREAD_NAME(name) traceSetThreadName(name)
+#define SNAKE_TRACE_WRITE(path) writeChromeTrace(path)
+
+#else
+
+#define SNAKE_TRACE_ZONE(name) ((void)0)
+#define SNAKE_TRACE_THREAD_NAME(name) ((void)0)
+#define SNAKE_TRACE_WRITE(path) false
+
+#endif // SNAKE_TRACE
+
+#endif // SNAKE_TRACE_H
@@ -0,0 +1,140 @@
+#include "VecEngine.h"
+#include <algorithm>
+
+VecEngine::VecEngine(int count, int cols, int rows, unsigned int seed)
+        : boardCount(count), boardCols(cols), boardRows(rows), cells(cols * rows), words((cols * rows + 63) / 64),
+          baseSeed(seed), headX(count), headY(count), dirs(count), lengths(count), ringHead(count), foodCell(count),
+          freeCount(count), episodeCount(count), rngs(count),
+          body(static_cast<size_t>(count) * cells), freeCells(static_cast<size_t>(count) * cells),
+          slotOf(static_cast<size_t>(count) * cells), occupied(static_cast<size_t>(count) * words),
+          nextCell(count), grows(count) {
+    reset(seed);
+}
+
+void VecEngine::reset(unsigned int seed) {
+    baseSeed = seed;
+    std::fill(episodeCount.begin(), episodeCount.end(), 0);
+    for (int i = 0; i < boardCount; ++i) {
+        resetBoard(i);
+    }
+}
+
+void VecEngine::resetBoard(int i) {
+    rngs[i].seed(baseSeed + static_cast<unsigned int>(i) + episodeCount[i] * static_cast<unsigned int>(boardCount));
+
+    uint64_t* bits = &occupied[static_cast<size_t>(i) * words];
+    std::fill(bits, bits + words, 0);
+    int32_t* freeList = &freeCells[static_cast<size_t>(i) * cells];
+    int32_t* slots = &slotOf[static_cast<size_t>(i) * cells];
+    for (int c = 0; c < cells; ++c) {
+        freeList[c] = c;
+        slots[c] = c;
+    }
+    freeCount[i] = cells;
+
+    // 与 SnakeEngine::reset() 相同：三格长的蛇位于棋盘中央，朝右
+    int32_t* ring = &body[static_cast<size_t>(i) * cells];
+    int y = boardRows / 2;
+    ringHead[i] = cells - 3;
+    for (int k = 0; k < 3; ++k) {
+        int cell = y * boardCols + boardCols / 2 - k;
+        ring[cells - 3 + k] = cell;
+        bits[cell >> 6] |= uint64_t(1) << (cell & 63);
+        occupy(i, cell);
+    }
+    headX[i] = boardCols / 2;
+    headY[i] = y;
+    dirs[i] = RIGHT;
+    lengths[i] = 3;
+
+    generateFood(i);
+}
+
+void VecEngine::occupy(int i, int cell) {
+    int32_t* freeList = &freeCells[static_cast<size_t>(i) * cells];
+    int32_t* slots = &slotOf[static_cast<size_t>(i) * cells];
+    int slot = slots[cell];
+    int last = freeList[--freeCount[i]];
+    freeList[slot] = last;
+    slots[last] = slot;
+    slots[cell] = -1;
+}
+
+void VecEngine::release(int i, int cell) {
+    int32_t* freeList = &freeCells[static_cast<size_t>(i) * cells];
+    int32_t* slots = &slotOf[static_cast<size_t>(i) * cells];
+    slots[cell] = freeCount[i];
+    freeList[freeCount[i]++] = cell;
+}
+
+bool VecEngine::generateFood(int i) {
+    if (freeCount[i] == 0) {
+        return false;
+    }
+    const int32_t* freeList = &freeCells[static_cast<size_t>(i) * cells];
+    foodCell[i] = freeList[rngs[i].bounded(static_cast<uint32_t>(freeCount[i]))];
+    return true;
+}
+
+void VecEngine::step(const Direction* actions, StepResult* results) {
+    // 第一遍：只做逐元素运算、没有分支，便于编译器向量化
+    // 方向枚举中相反方向只差最低位（UP^1 == DOWN，LEFT^1 == RIGHT）
+    for (int i = 0; i < boardCount; ++i) {
+        uint8_t d = dirs[i];
+        uint8_t a = static_cast<uint8_t>(actions[i]);
+        d = a == (d ^ 1) ? d : a;
+        dirs[i] = d;
+        int nx = headX[i] + (d == RIGHT) - (d == LEFT);
+        int ny = headY[i] + (d == DOWN) - (d == UP);
+        bool inside = static_cast<unsigned int>(nx) < static_cast<unsigned int>(boardCols) &&
+                      static_cast<unsigned int>(ny) < static_cast<unsigned int>(boardRows);
+        int cell = inside ? ny * boardCols + nx : -1;
+        nextCell[i] = cell;
+        grows[i] = cell == foodCell[i];
+    }
+
+    // 第二遍：逐个棋盘查占用位图、移动蛇身、补食物
+    for (int i = 0; i < boardCount; ++i) {
+        int cell = nextCell[i];
+        bool grow = grows[i] != 0;
+        uint64_t* bits = &occupied[static_cast<size_t>(i) * words];
+        int32_t* ring = &body[static_cast<size_t>(i) * cells];
+        int tailSlot = ringHead[i] + lengths[i] - 1;
+        if (tailSlot >= cells) tailSlot -= cells;
+        int tailCell = ring[tailSlot];
+
+        // 撞墙或撞到自己；不增长时蛇尾会让出格子
+        if (cell < 0 || (((bits[cell >> 6] >> (cell & 63)) & 1) && (grow || cell != tailCell))) {
+            results[i] = STEP_DIED;
+            continue;
+        }
+
+        if (!grow) {
+            bits[tailCell >> 6] &= ~(uint64_t(1) << (tailCell & 63));
+            release(i, tailCell);
+            --lengths[i];
+        }
+
+        ringHead[i] = (ringHead[i] == 0 ? cells : ringHead[i]) - 1;
+        ring[ringHead[i]] = cell;
+        bits[cell >> 6] |= uint64_t(1) << (cell & 63);
+        occupy(i, cell);
+        ++lengths[i];
+        headX[i] = cell % boardCols;
+        headY[i] = cell / boardCols;
+
+        if (!grow) {
+            results[i] = STEP_MOVED;
+        } else {
+            results[i] = generateFood(i) ? STEP_ATE : STEP_WON;
+        }
+    }
+
+    // 结束的棋盘自动重开
+    for (int i = 0; i < boardCount; ++i) {
+        if (results[i] == STEP_DIED || results[i] == STEP_WON) {
+            ++episodeCount[i];
+            resetBoard(i);
+        }
+    }
+}
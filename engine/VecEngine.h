@@ -0,0 +1,76 @@
+#ifndef SNAKE_VEC_ENGINE_H
+#define SNAKE_VEC_ENGINE_H
+
+#include "SnakeEngine.h"
+#include <vector>
+#include <cstdint>
+
+// 批量环境：N 个同尺寸棋盘按结构数组（SoA）存放，一次 step() 推进全部棋盘
+// 规则与 SnakeEngine::step() 完全一致；结束的棋盘会自动以下一个种子重开
+class VecEngine {
+public:
+    // 第 i 个棋盘第 k 局的种子为 seed + i + k * count
+    VecEngine(int count, int cols, int rows, unsigned int seed);
+
+    void reset(unsigned int seed);
+    // actions 与 results 均为 count 个元素；results 为这一步的结果（重开之前）
+    void step(const Direction* actions, StepResult* results);
+
+    int count() const { return boardCount; }
+    int cols() const { return boardCols; }
+    int rows() const { return boardRows; }
+
+    Position head(int i) const { return {headX[i], headY[i]}; }
+    Position food(int i) const { return {foodCell[i] % boardCols, foodCell[i] / boardCols}; }
+    Direction direction(int i) const { return static_cast<Direction>(dirs[i]); }
+    int length(int i) const { return lengths[i]; }
+    // 第 i 个棋盘从蛇头数起的第 k 节
+    Position segment(int i, int k) const {
+        int slot = ringHead[i] + k;
+        if (slot >= cells) slot -= cells;
+        int cell = body[static_cast<size_t>(i) * cells + slot];
+        return {cell % boardCols, cell / boardCols};
+    }
+    // 第 i 个棋盘的占用位图，每个格子一位，共 wordsPerBoard() 个 64 位字
+    const uint64_t* occupancy(int i) const { return &occupied[static_cast<size_t>(i) * words]; }
+    int wordsPerBoard() const { return words; }
+    // 第 i 个棋盘已经结束过的局数
+    unsigned int episodes(int i) const { return episodeCount[i]; }
+
+private:
+    void resetBoard(int i);
+    bool generateFood(int i);
+    void occupy(int i, int cell);
+    void release(int i, int cell);
+
+    int boardCount;
+    int boardCols;
+    int boardRows;
+    int cells;
+    int words;
+    unsigned int baseSeed;
+
+    // 每个棋盘一个元素
+    std::vector<int32_t> headX;
+    std::vector<int32_t> headY;
+    std::vector<uint8_t> dirs;
+    std::vector<int32_t> lengths;
+    std::vector<int32_t> ringHead;
+    std::vector<int32_t> foodCell;
+    std::vector<int32_t> freeCount;
+    std::vector<uint32_t> episodeCount;
+    std::vector<Rng> rngs;
+
+    // 每个棋盘 cells 个元素：环形蛇身、空格数组、格子在空格数组中的位置
+    std::vector<int32_t> body;
+    std::vector<int32_t> freeCells;
+    std::vector<int32_t> slotOf;
+    // 每个棋盘 words 个字
+    std::vector<uint64_t> occupied;
+
+    // step() 的临时数组
+    std::vector<int32_t> nextCell;
+    std::vector<uint8_t> grows;
+};
+
+#endif // SNAKE_VEC_ENGINE_H
@@ -1,92 +1,182 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <iostream>
-#include <vector>
 #include <ctime>
 #include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include "SnakeEngine.h"
+#include "Replay.h"
+#include "Policy.h"
+#include "NetClient.h"
+#include "SnakeRenderer.h"
+#include "AssetManager.h"
+#include "GameAssets.h"
+#include "FrameStats.h"
+#include "Trace.h"
 #undef main // 这样就可以解决 undefwinmain 的问题
 // 游戏设置
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 const int CELL_SIZE = 20;
+// 窗口一屏能显示的格子数，棋盘比这大时镜头跟随蛇头
+const int VIEW_COLS = SCREEN_WIDTH / CELL_SIZE;
+const int VIEW_ROWS = SCREEN_HEIGHT / CELL_SIZE;
+// 默认逻辑帧率（每秒移动的步数）
+const int DEFAULT_TICK_RATE = 10;
+// 逻辑帧率上限；再高时每步的计数器间隔会取整为 0
+const int MAX_TICK_RATE = 1000;
+// 卡顿后最多补算的逻辑帧数，避免越追越慢
+const int MAX_CATCHUP_TICKS = 5;
 
-// 枚举方向
-enum Direction { UP, DOWN, LEFT, RIGHT };
+// F9 导出时间线追踪的文件
+const char* const TRACE_FILE = "snake_trace.json";
 
-// 枚举游戏的状态
-enum GameState { MENU, PLAYING, SETTING };
+// 不限速回放时每帧用于推进逻辑的时间上限，剩下的时间留给绘制
+const double REPLAY_FRAME_BUDGET_MS = 8.0;
+
+// 每个逻辑帧最多消化一次转向，来不及消化的按键在此排队
+const int INPUT_QUEUE_SIZE = 3;
 
-// 位置结构体
-struct Position {
-    int x, y;
+// 等待服务器答复加入申请的时间
+const int CONNECT_TIMEOUT_MS = 3000;
+
+// 枚举游戏的状态
+enum GameState { LOADING, MENU, PLAYING, SETTING };
+
+// 启动参数
+struct GameOptions {
+    int tickRate = 0;                  // 每秒逻辑步数，0 表示默认（回放时为不限速）
+    bool fullRedraw = false;           // 关闭增量绘制，每帧整体重画
+    std::string statsCsv = "frame_times.csv";  // 随帧写入每帧耗时的文件
+    std::string recordFile = "last_game.snkr";  // 退出时保存本局录像的文件
+    const Replay* replay = nullptr;             // 非空时回放该录像而不是开新局
+    std::string autopilot;                      // 非空时由该名字的策略代替键盘操作
+    int boardCols = 0;                          // 棋盘尺寸（格），0 表示与窗口一样大
+    int boardRows = 0;
+    NetClient* net = nullptr;                   // 非空时作为联机客户端：局面来自服务器，转向发给服务器
 };
 
-// 加载图片为纹理的函数
-SDL_Texture* loadTexture(const std::string& path, SDL_Renderer* renderer) {
-    SDL_Texture* newTexture = nullptr;
-    SDL_Surface* loadedSurface = IMG_Load(path.c_str());
-    if (loadedSurface == nullptr) {
-        std::cerr << "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
-    } else {
-        newTexture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
-        if (newTexture == nullptr) {
-            std::cerr << "Unable to create texture from " << path << "! SDL Error: " << SDL_GetError() << std::endl;
-        }
-        SDL_FreeSurface(loadedSurface);
-    }
-    return newTexture;
-}
+// 排队中的一次转向
+struct QueuedTurn {
+    Direction dir;
+    Uint64 pressedAt;  // 按下时的性能计数器
+};
 
 // 游戏类
 class SnakeGame {
 public:
-    SnakeGame();
+    explicit SnakeGame(const GameOptions& options);
     ~SnakeGame();
     void run();
 
 private:
-    SDL_Texture* backgroundTexture;
-    SDL_Texture* startButtonTexture;
-    SDL_Texture* menuButtonTexture;
+    // 图片在后台线程解码，加载期间显示进度条
+    AssetManager assets;
 
-    SDL_Texture* snakeHeadTexture;
-    SDL_Texture* snakeBodyTexture;
-    SDL_Texture* snakeTailTexture;
+    // 蛇与食物共用一张图集批量绘制
+    SnakeRenderer snakeRenderer;
 
     void processInput();
+    void pollAssets();
+    void queueTurn(Direction turn);
     void update();
+    void updateNetwork();
     void render();
+    void present();
+    void renderLoading();
     void renderMenu();
+    void renderButton(SDL_Texture* texture, const SDL_Rect& rect);
     void renderGame();
-    void generateFood();
-    bool checkCollision();
+    SDL_Rect cameraView() const;
     bool isButtonClicked(int x, int y, int btnx, int btny, int btnw, int btnh);
 
     SDL_Window* window;
     SDL_Renderer* renderer;
+    int tickRate;
+    bool vsync;
+    bool incremental;
     bool running;
     GameState gameState;
-    Direction dir;
-    std::vector<Position> snake;
-    Position food;
-    bool growSnake;
+    GameState renderedState;  // 上一帧绘制时的状态，切换后需要整体重画
+    std::chrono::steady_clock::time_point startedAt;  // 构造开始的时间，用于统计启动到首帧的耗时
+    bool firstFramePresented;
+    SnakeEngine engine;
+    bool scrolling;  // 棋盘大于窗口，只画镜头内的部分
+
+    // 录像：正常游戏时记录转向，回放时按录像驱动 engine
+    Replay replay;
+    ReplayPlayer replayPlayer;
+    bool replaying;
+    bool uncapped;  // 回放且未指定逻辑帧率时不限速
+    std::string recordFile;
+
+    // 自动驾驶：非空时方向由策略给出，不再响应方向键
+    std::unique_ptr<Policy> policy;
+
+    // 联机：非空时不在本地推进 engine，画面取自服务器快照还原的局面
+    NetClient* net;
+
+    // 转向队列（环形，容量 INPUT_QUEUE_SIZE）
+    QueuedTurn turnQueue[INPUT_QUEUE_SIZE];
+    int turnQueueHead;
+    int turnQueueCount;
+
+    // 输入延迟统计：从按键到画面提交
+    std::vector<Uint64> appliedTurns;  // 已生效、尚未显示的转向的按下时间
+    long long latencyCount;
+    double latencyTotalMs;
+    double latencyMaxMs;
+
+    // 各阶段耗时统计，F3 显示/隐藏面板
+    FrameStats frameStats;
+    bool showStats;
+    std::string statsCsv;
 };
 
-SnakeGame::SnakeGame()
-        : window(nullptr), renderer(nullptr), running(true), gameState(MENU), dir(RIGHT), growSnake(false),
-          backgroundTexture(nullptr), startButtonTexture(nullptr), menuButtonTexture(nullptr),
-          snakeHeadTexture(nullptr), snakeBodyTexture(nullptr), snakeTailTexture(nullptr) {
+SnakeGame::SnakeGame(const GameOptions& options)
+        : window(nullptr), renderer(nullptr), tickRate(options.tickRate), vsync(false), incremental(false),
+          running(true), gameState(LOADING), renderedState(LOADING), startedAt(std::chrono::steady_clock::now()),
+          firstFramePresented(false), engine(options.boardCols, options.boardRows, 0),
+          scrolling(options.boardCols > VIEW_COLS || options.boardRows > VIEW_ROWS),
+          replayPlayer(replay), replaying(options.replay != nullptr),
+          uncapped(replaying && options.tickRate == 0), recordFile(options.recordFile), net(options.net),
+          turnQueueHead(0), turnQueueCount(0), latencyCount(0), latencyTotalMs(0.0), latencyMaxMs(0.0),
+          showStats(false), statsCsv(options.statsCsv) {
+    SNAKE_TRACE_THREAD_NAME("main");
+    if (!statsCsv.empty() && !frameStats.openCsv(statsCsv)) {
+        std::cerr << "Unable to write " << statsCsv << std::endl;
+    }
+    if (tickRate <= 0) {
+        tickRate = DEFAULT_TICK_RATE;
+    }
+    if (replaying) {
+        // 回放：棋盘尺寸已在启动时按录像设定
+        replay = *options.replay;
+        replayPlayer.start(engine);
+    } else {
+        if (!options.autopilot.empty()) {
+            policy = createPolicy(options.autopilot);
+        }
+        // 以当前时间为随机数种子开局，种子写进录像
+        unsigned int seed = static_cast<unsigned int>(time(0));
+        engine.reset(seed);
+        replay.begin(engine.cols(), engine.rows(), seed);
+    }
     // 初始化 SDL
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
         running = false;
         return;
     }
-    // 初始化 SDL_image
+    // 初始化 SDL_image；失败时仍可使用资源包，缺失的图片各自退回占位绘制
     if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
         std::cerr << "SDL_image could not initialize! SDL_image Error: " << IMG_GetError() << std::endl;
-        running = false;
-        return;
     }
     // 创建窗口
     window = SDL_CreateWindow("Snake Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
@@ -96,47 +186,50 @@ SnakeGame::SnakeGame()
         return;
     }
 
-    // 创建渲染器
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    // 创建渲染器，画面跟随显示器刷新率
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
     if (renderer == nullptr) {
         std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
         running = false;
         return;
     }
-    // 加载图片纹理
-    backgroundTexture = loadTexture("picture\\background.png", renderer);
-    startButtonTexture = loadTexture("picture\\startbutton.png", renderer);
-    menuButtonTexture = loadTexture("picture\\setting.png", renderer);
-
-    snakeHeadTexture = loadTexture("picture\\Snakehead.png", renderer);
-    snakeBodyTexture = loadTexture("picture\\Snakebody.png", renderer);
-    snakeTailTexture = loadTexture("picture\\Snaketail.png", renderer);
-
-    if (backgroundTexture == nullptr || startButtonTexture == nullptr || menuButtonTexture == nullptr ||
-        snakeHeadTexture == nullptr || snakeBodyTexture == nullptr || snakeTailTexture == nullptr) {
-        running = false;
-        return;
+    SDL_RendererInfo rendererInfo;
+    if (SDL_GetRendererInfo(renderer, &rendererInfo) == 0) {
+        vsync = (rendererInfo.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
     }
-    // 初始化随机数种子
-    srand(static_cast<unsigned int>(time(0)));
+    // 开始在后台加载图片，窗口先显示进度条
+    assets.start(GAME_ASSETS, ASSET_COUNT, GAME_BUNDLE_PATH);
 
-    // 初始化蛇
-    snake.push_back({SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2});
-    snake.push_back({SCREEN_WIDTH / 2 - CELL_SIZE, SCREEN_HEIGHT / 2});
-    snake.push_back({SCREEN_WIDTH / 2 - 2 * CELL_SIZE, SCREEN_HEIGHT / 2});
-
-    // 生成食物
-    generateFood();
+    // 增量绘制需要渲染目标纹理，不支持时每帧整体重画；镜头会移动的大棋盘和联机画面每帧都要整体重画视口，
+    // 不限速回放每帧推进很多步，变动的格子太多，也整体重画
+    if (!options.fullRedraw && !scrolling && !net && !uncapped) {
+        incremental = snakeRenderer.enableIncremental(renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
+    }
 }
 
 SnakeGame::~SnakeGame() {
-    SDL_DestroyTexture(backgroundTexture);
-    SDL_DestroyTexture(startButtonTexture);
-    SDL_DestroyTexture(menuButtonTexture);
+    if (!replaying && engine.ticks() > 0 && !recordFile.empty()) {
+        replay.finish(engine.ticks(), engine.stateHash());
+        if (replay.save(recordFile)) {
+            std::cout << "Replay written to " << recordFile << std::endl;
+        } else {
+            std::cerr << "Unable to write " << recordFile << std::endl;
+        }
+    }
+    if (latencyCount > 0) {
+        std::cout << "Input latency: avg " << latencyTotalMs / latencyCount << " ms, max " << latencyMaxMs
+                  << " ms over " << latencyCount << " turns" << std::endl;
+    }
+    if (frameStats.csvOpen()) {
+        if (frameStats.closeCsv()) {
+            std::cout << "Frame times written to " << statsCsv << std::endl;
+        } else {
+            std::cerr << "Unable to write " << statsCsv << std::endl;
+        }
+    }
 
-    SDL_DestroyTexture(snakeHeadTexture);
-    SDL_DestroyTexture(snakeBodyTexture);
-    SDL_DestroyTexture(snakeTailTexture);
+    assets.release();
+    snakeRenderer.release();
 
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
@@ -145,31 +238,80 @@ SnakeGame::~SnakeGame() {
 }
 
 void SnakeGame::run() {
-    const int FPS = 10;
-    const int frameDelay = 1000 / FPS;
-    Uint32 frameStart;
-    int frameTime;
+    // 固定步长：逻辑按 tickRate 推进，输入与绘制每帧都做
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    const Uint64 tickLength = std::max<Uint64>(1, frequency / tickRate);
+    Uint64 previous = SDL_GetPerformanceCounter();
+    Uint64 accumulator = 0;
+
+    const float msPerCount = 1000.0f / frequency;
 
     while (running) {
-        frameStart = SDL_GetTicks();
+        Uint64 now = SDL_GetPerformanceCounter();
+        accumulator += now - previous;
+        previous = now;
+        if (accumulator > tickLength * MAX_CATCHUP_TICKS) {
+            accumulator = tickLength * MAX_CATCHUP_TICKS;
+        }
 
         processInput();
-        update();
+        if (gameState == LOADING) {
+            pollAssets();
+        }
+        Uint64 inputDone = SDL_GetPerformanceCounter();
+        if (net) {
+            // 联机：逻辑帧由服务器推进，每帧收下已到达的快照
+            updateNetwork();
+            accumulator = 0;
+        } else if (uncapped && gameState == PLAYING) {
+            // 不限速回放：在本帧的时间预算内尽量多推进
+            const Uint64 budget = static_cast<Uint64>(REPLAY_FRAME_BUDGET_MS * frequency / 1000.0);
+            do {
+                update();
+            } while (running && SDL_GetPerformanceCounter() - inputDone < budget);
+            accumulator = 0;
+        }
+        while (running && accumulator >= tickLength) {
+            update();
+            accumulator -= tickLength;
+        }
+        Uint64 updateDone = SDL_GetPerformanceCounter();
         render();
-
-        // 控制帧率
-        frameTime = SDL_GetTicks() - frameStart;
-        if (frameDelay > frameTime) {
-            SDL_Delay(frameDelay - frameTime);
+        Uint64 renderDone = SDL_GetPerformanceCounter();
+        present();
+        Uint64 presentDone = SDL_GetPerformanceCounter();
+
+        // 记录本帧各阶段耗时
+        const float phaseMs[FrameStats::PHASE_COUNT] = {
+                (inputDone - now) * msPerCount, (updateDone - inputDone) * msPerCount,
+                (renderDone - updateDone) * msPerCount, (presentDone - renderDone) * msPerCount,
+                (presentDone - now) * msPerCount};
+        frameStats.addFrame(phaseMs);
+
+        // 没有垂直同步时稍作等待，避免空转占满 CPU
+        if (!vsync) {
+            SDL_Delay(1);
         }
     }
 }
 
 void SnakeGame::processInput() {
+    SNAKE_TRACE_ZONE("processInput");
     SDL_Event event;
     while (SDL_PollEvent(&event) != 0) {
         if (event.type == SDL_QUIT) {
             running = false;
+        } else if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET ||
+                   (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)) {
+            // 渲染目标内容可能已丢失
+            snakeRenderer.invalidate();
+        } else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3) {
+            showStats = !showStats;
+        } else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F9) {
+            // 编译时开启 SNAKE_TRACE 才有记录
+            if (SNAKE_TRACE_WRITE(TRACE_FILE)) {
+                std::cout << "Trace written to " << TRACE_FILE << std::endl;
+            }
         } else if (event.type == SDL_MOUSEBUTTONDOWN && gameState == MENU) {
             int x, y;
             SDL_GetMouseState(&x, &y);
@@ -181,193 +323,346 @@ void SnakeGame::processInput() {
             if (isButtonClicked(x, y, SCREEN_WIDTH / 2 - 50, 400, 100, 50)) {
                 gameState = SETTING;
             }
-        } else if (event.type == SDL_KEYDOWN && gameState == PLAYING) {
+        } else if (event.type == SDL_KEYDOWN && gameState == PLAYING && !replaying && !policy) {
             switch (event.key.keysym.sym) {
-                case SDLK_UP:
-                    if (dir != DOWN) dir = UP;
-                    break;
-                case SDLK_DOWN:
-                    if (dir != UP) dir = DOWN;
-                    break;
-                case SDLK_LEFT:
-                    if (dir != RIGHT) dir = LEFT;
-                    break;
-                case SDLK_RIGHT:
-                    if (dir != LEFT) dir = RIGHT;
-                    break;
+                case SDLK_UP: queueTurn(UP); break;
+                case SDLK_DOWN: queueTurn(DOWN); break;
+                case SDLK_LEFT: queueTurn(LEFT); break;
+                case SDLK_RIGHT: queueTurn(RIGHT); break;
             }
         }
     }
 }
 
+void SnakeGame::pollAssets() {
+    if (!assets.pump(renderer)) {
+        return;
+    }
+
+    // 全部图片处理完：生成蛇的图集，缺失的贴图由图集用纯色方块代替
+    if (!snakeRenderer.buildAtlas(renderer, assets.surface(ASSET_SNAKE_HEAD), assets.surface(ASSET_SNAKE_BODY),
+                                  assets.surface(ASSET_SNAKE_TAIL))) {
+        running = false;
+        return;
+    }
+    assets.dropSurfaces();
+
+    std::chrono::duration<double, std::milli> loading = std::chrono::steady_clock::now() - startedAt;
+    std::cout << "Assets loaded in " << loading.count() << " ms" << std::endl;
+    // 回放、自动驾驶和联机时跳过菜单
+    gameState = (replaying || policy || net) ? PLAYING : MENU;
+}
+
+void SnakeGame::queueTurn(Direction turn) {
+    // 与队尾（队列为空时与当前方向）相同或相反的按键没有意义，直接丢弃
+    Direction last = net ? net->direction() : engine.direction();
+    if (turnQueueCount > 0) {
+        last = turnQueue[(turnQueueHead + turnQueueCount - 1) % INPUT_QUEUE_SIZE].dir;
+    }
+    if (turn == last || turn == opposite(last) || turnQueueCount == INPUT_QUEUE_SIZE) {
+        return;
+    }
+    turnQueue[(turnQueueHead + turnQueueCount) % INPUT_QUEUE_SIZE] = {turn, SDL_GetPerformanceCounter()};
+    ++turnQueueCount;
+}
+
 void SnakeGame::update() {
+    SNAKE_TRACE_ZONE("update");
     if (gameState == PLAYING) {
-        // 移动蛇
-        Position newHead = snake[0];
-        switch (dir) {
-            case UP: newHead.y -= CELL_SIZE; break;
-            case DOWN: newHead.y += CELL_SIZE; break;
-            case LEFT: newHead.x -= CELL_SIZE; break;
-            case RIGHT: newHead.x += CELL_SIZE; break;
+        // 每个逻辑帧取出一次转向，并以实际生效的方向校验，不能掉头撞向脖子
+        Direction next = engine.direction();
+        if (replaying) {
+            next = replayPlayer.nextAction(engine);
+        } else if (policy) {
+            next = policy->decide(engine);
+        }
+        while (!replaying && !policy && turnQueueCount > 0) {
+            QueuedTurn turn = turnQueue[turnQueueHead];
+            turnQueueHead = (turnQueueHead + 1) % INPUT_QUEUE_SIZE;
+            --turnQueueCount;
+            if (turn.dir != next && turn.dir != opposite(next)) {
+                next = turn.dir;
+                appliedTurns.push_back(turn.pressedAt);
+                break;
+            }
         }
 
-        // 检查是否吃到食物
-        if (newHead.x == food.x && newHead.y == food.y) {
-            growSnake = true;
-            generateFood();
+        const SnakeBody& snake = engine.body();
+        Position oldHead = snake.front();
+        Position oldTail = snake.back();
+        Position oldFood = engine.food();
+        Direction oldDir = engine.direction();
+        long long tick = engine.ticks();
+
+        StepResult result = engine.step(next);
+        if (!replaying && engine.direction() != oldDir) {
+            replay.recordTurn(tick, engine.direction());
         }
 
-        // 检查碰撞
-        if (checkCollision()) {
+        // 记录本步变动的格子，增量绘制只重画这些格子
+        if (incremental && result != STEP_DIED) {
+            snakeRenderer.markDirty(oldHead);
+            snakeRenderer.markDirty(oldTail);
+            snakeRenderer.markDirty(oldFood);
+            snakeRenderer.markDirty(snake.front());
+            snakeRenderer.markDirty(snake.back());
+            snakeRenderer.markDirty(engine.food());
+        }
+        if (replaying && replayPlayer.done(engine)) {
+            std::cout << "Replay finished at tick " << engine.ticks() << ": final state "
+                      << (replayPlayer.matches(engine) ? "matches" : "DOES NOT MATCH") << " the recording"
+                      << std::endl;
+            running = false;
+        } else if (result == STEP_DIED) {
+            running = false;
+        } else if (result == STEP_WON) {
+            std::cout << "You Win!" << std::endl;
             running = false;
-            return;
         }
+    }
+}
 
-        // 更新蛇的位置
-        snake.insert(snake.begin(), newHead);
-        if (!growSnake) {
-            snake.pop_back();
-        } else {
-            growSnake = false;
+void SnakeGame::updateNetwork() {
+    SNAKE_TRACE_ZONE("updateNetwork");
+    if (!net->poll()) {
+        return;
+    }
+    // 每收到一个快照消化一次转向，连同确认的 tick 一起发回服务器；蛇死后由服务器重新放置
+    Direction next = net->direction();
+    while (turnQueueCount > 0) {
+        QueuedTurn turn = turnQueue[turnQueueHead];
+        turnQueueHead = (turnQueueHead + 1) % INPUT_QUEUE_SIZE;
+        --turnQueueCount;
+        if (turn.dir != next && turn.dir != opposite(next)) {
+            next = turn.dir;
+            break;
         }
     }
+    net->sendInput(next);
 }
 
 void SnakeGame::render() {
-    if (gameState == MENU) {
+    if (gameState != renderedState) {
+        snakeRenderer.invalidate();
+        renderedState = gameState;
+    }
+
+    if (gameState == LOADING) {
+        renderLoading();
+    } else if (gameState == MENU) {
         renderMenu();
     } else if (gameState == PLAYING) {
         renderGame();
     }
+
+    if (showStats) {
+        frameStats.drawOverlay(renderer, 8, 8);
+    }
+}
+
+void SnakeGame::present() {
+    SNAKE_TRACE_ZONE("present");
+    // 每帧都提交画面，开启垂直同步时由它控制帧间隔
+    SDL_RenderPresent(renderer);
+
+    if (!firstFramePresented) {
+        firstFramePresented = true;
+        std::chrono::duration<double, std::milli> startup = std::chrono::steady_clock::now() - startedAt;
+        std::cout << "Startup to first frame: " << startup.count() << " ms" << std::endl;
+    }
+
+    // 本帧已显示的转向计入输入延迟
+    if (!appliedTurns.empty()) {
+        Uint64 now = SDL_GetPerformanceCounter();
+        double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+        for (size_t i = 0; i < appliedTurns.size(); ++i) {
+            double ms = (now - appliedTurns[i]) * 1000.0 / frequency;
+            latencyTotalMs += ms;
+            if (ms > latencyMaxMs) latencyMaxMs = ms;
+            ++latencyCount;
+        }
+        appliedTurns.clear();
+    }
+}
+
+void SnakeGame::renderLoading() {
+    SNAKE_TRACE_ZONE("renderLoading");
+    // 清屏
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+
+    // 进度条
+    SDL_Rect frame = {SCREEN_WIDTH / 4, SCREEN_HEIGHT / 2 - 10, SCREEN_WIDTH / 2, 20};
+    SDL_Rect bar = {frame.x + 2, frame.y + 2, static_cast<int>((frame.w - 4) * assets.progress()), frame.h - 4};
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderDrawRect(renderer, &frame);
+    SDL_SetRenderDrawColor(renderer, 0, 180, 0, 255);
+    SDL_RenderFillRect(renderer, &bar);
 }
 
 void SnakeGame::renderMenu() {
+    SNAKE_TRACE_ZONE("renderMenu");
     // 清屏
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
-    // 渲染背景
-    SDL_RenderCopy(renderer, backgroundTexture, nullptr, nullptr);  // 将整个窗口渲染为背景图片
+    // 渲染背景（背景图缺失时保持黑色）
+    SDL_Texture* backgroundTexture = assets.texture(ASSET_BACKGROUND);
+    if (backgroundTexture != nullptr) {
+        SDL_RenderCopy(renderer, backgroundTexture, nullptr, nullptr);  // 将整个窗口渲染为背景图片
+    }
 
     // 渲染“开始游戏”按钮
     SDL_Rect startButtonRect = {SCREEN_WIDTH / 2 - 50, 300, 80, 50};  // 定义按钮的位置和大小
-    SDL_RenderCopy(renderer, startButtonTexture, nullptr, &startButtonRect);
+    renderButton(assets.texture(ASSET_START_BUTTON), startButtonRect);
 
     // 渲染“设置”按钮
     SDL_Rect settingsButtonRect = {SCREEN_WIDTH / 2 - 50, 400, 80, 50};
-    SDL_RenderCopy(renderer, menuButtonTexture, nullptr, &settingsButtonRect);
+    renderButton(assets.texture(ASSET_SETTING_BUTTON), settingsButtonRect);
+}
 
-    // 显示渲染的内容
-    SDL_RenderPresent(renderer);
+void SnakeGame::renderButton(SDL_Texture* texture, const SDL_Rect& rect) {
+    if (texture != nullptr) {
+        SDL_RenderCopy(renderer, texture, nullptr, &rect);
+    } else {
+        // 按钮图片缺失时画一个灰色方块，仍然可以点击
+        SDL_SetRenderDrawColor(renderer, 128, 128, 128, 255);
+        SDL_RenderFillRect(renderer, &rect);
+    }
 }
 
 void SnakeGame::renderGame() {
+    SNAKE_TRACE_ZONE("renderGame");
     // 清屏
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
-    // 绘制蛇
-    for (size_t i = 0; i < snake.size(); ++i) {
-        SDL_Rect rect = {snake[i].x, snake[i].y, CELL_SIZE, CELL_SIZE};
-        SDL_Texture* texture = nullptr;
-        double angle = 0.0;
-
-        if (i == 0) {
-            // 蛇头
-            texture = snakeHeadTexture;
-            // 根据方向设置角度
-            switch (dir) {
-                case UP: angle = 90.0; break;
-                case DOWN: angle = 270.0; break;
-                case LEFT: angle = 0.0; break;
-                case RIGHT: angle = 180.0; break;
-            }
-        }else if (i == snake.size() - 1) {
-            // 蛇尾
-            texture = snakeTailTexture;
-            if (snake.size() > 1) {
-                // 当前段
-                const Position& currentSegment = snake[i];
-                // 前一个段
-                const Position& prevSegment = snake[i + 1];
-
-                // 计算前一个段与当前段之间的方向
-                if (prevSegment.x == currentSegment.x) {
-                    // 垂直
-                    if (prevSegment.y < currentSegment.y) {
-                        // 向下
-                        angle = 90.0;
-                    } else {
-                        // 向上
-                        angle = 270.0;
-                    }
-                } else {
-                    // 水平
-                    if (prevSegment.x < currentSegment.x) {
-                        // 向右
-                        angle = 0.0;
-                    } else {
-                        // 向左
-                        angle = 180.0;
-                    }
-                }
-            }
-        } else {
-            // 蛇身
-            texture = snakeBodyTexture;
-            // 这里你可以设置蛇身的角度（如果需要）
+    // 绘制蛇和食物（一次提交）
+    if (scrolling || net) {
+        // 棋盘以外的区域涂成深灰，与空格区分开
+        SDL_Rect view = cameraView();
+        SDL_Rect board = {0, 0, std::min(view.w, engine.cols() - view.x) * CELL_SIZE,
+                          std::min(view.h, engine.rows() - view.y) * CELL_SIZE};
+        if (board.w < SCREEN_WIDTH || board.h < SCREEN_HEIGHT) {
+            SDL_SetRenderDrawColor(renderer, 40, 40, 40, 255);
+            SDL_RenderClear(renderer);
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+            SDL_RenderFillRect(renderer, &board);
         }
-
-        if (texture != nullptr) {
-            SDL_RenderCopyEx(renderer, texture, nullptr, &rect, angle, nullptr, SDL_FLIP_NONE);
+        if (net) {
+            snakeRenderer.drawWorld(renderer, net->mirror(), view, CELL_SIZE);
+        } else {
+            snakeRenderer.drawView(renderer, engine.body(), engine.direction(), engine.food(), engine.occupancy(),
+                                   engine.slots(), view, CELL_SIZE);
         }
+    } else if (incremental) {
+        snakeRenderer.drawIncremental(renderer, engine.body(), engine.direction(), engine.food(), CELL_SIZE);
+    } else {
+        snakeRenderer.draw(renderer, engine.body(), engine.direction(), engine.food(), CELL_SIZE, 0, 0);
     }
-
-    // 绘制食物
-    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-    SDL_Rect foodRect = {food.x, food.y, CELL_SIZE, CELL_SIZE};
-    SDL_RenderFillRect(renderer, &foodRect);
-
-    // 显示更新
-    SDL_RenderPresent(renderer);
 }
 
-
-
-
-
-
-
-
-void SnakeGame::generateFood() {
-    food.x = (rand() % (SCREEN_WIDTH / CELL_SIZE)) * CELL_SIZE;
-    food.y = (rand() % (SCREEN_HEIGHT / CELL_SIZE)) * CELL_SIZE;
+SDL_Rect SnakeGame::cameraView() const {
+    // 以蛇头为中心，贴边时停住，不露出棋盘以外太多；联机时自己的蛇不在场则对准棋盘中央
+    Position head = engine.body().front();
+    if (net) {
+        const NetMirror& world = net->mirror();
+        head = world.isAlive(net->snake()) ? world.head(net->snake()) : Position{world.cols() / 2, world.rows() / 2};
+    }
+    int x = std::max(0, std::min(head.x - VIEW_COLS / 2, engine.cols() - VIEW_COLS));
+    int y = std::max(0, std::min(head.y - VIEW_ROWS / 2, engine.rows() - VIEW_ROWS));
+    return {x, y, VIEW_COLS, VIEW_ROWS};
 }
 
-bool SnakeGame::checkCollision() {
-    const Position& head = snake[0];
+bool SnakeGame::isButtonClicked(int x, int y, int btnX, int btnY, int btnW, int btnH) {
+    return x >= btnX && x <= btnX + btnW && y >= btnY && y <= btnY + btnH;
+}
 
-    // 检查是否撞墙
-    if (head.x < 0 || head.x >= SCREEN_WIDTH || head.y < 0 || head.y >= SCREEN_HEIGHT) {
-        return true;
+int main(int argc, char* argv[]) {
+    // --tick-rate N：每秒逻辑步数（最多 MAX_TICK_RATE）
+    // --full-redraw：关闭增量绘制
+    // --stats-csv FILE：随帧写入每帧耗时的文件（传空字符串则不写）
+    // --record FILE：退出时保存录像的文件（传空字符串则不保存）
+    // --replay FILE：回放录像（棋盘尺寸随录像）；不指定 --tick-rate 时不限速
+    // --board WxH：棋盘尺寸（格），大于窗口时镜头跟随蛇头
+    // --autopilot [NAME]：由策略自动操作（astar 或 hamilton，默认 astar），用于无人值守的长时间运行
+    // --connect [PORT]：加入本机 SnakeServer 的联机对局（默认端口 7777），棋盘尺寸随服务器
+    GameOptions options;
+    Replay replay;
+    NetClient client;
+    int connectPort = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            options.tickRate = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--full-redraw") == 0) {
+            options.fullRedraw = true;
+        } else if (std::strcmp(argv[i], "--stats-csv") == 0 && i + 1 < argc) {
+            options.statsCsv = argv[++i];
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            options.recordFile = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            if (!replay.load(argv[++i])) {
+                return 1;
+            }
+            options.replay = &replay;
+        } else if (std::strcmp(argv[i], "--autopilot") == 0) {
+            options.autopilot = "astar";
+            if (i + 1 < argc && std::strncmp(argv[i + 1], "--", 2) != 0) {
+                options.autopilot = argv[++i];
+            }
+            if (!createPolicy(options.autopilot)) {
+                std::cerr << "Unknown autopilot policy " << options.autopilot << std::endl;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--connect") == 0) {
+            connectPort = NET_DEFAULT_PORT;
+            if (i + 1 < argc && std::strncmp(argv[i + 1], "--", 2) != 0) {
+                connectPort = std::atoi(argv[++i]);
+            }
+        } else if (std::strcmp(argv[i], "--board") == 0 && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%dx%d", &options.boardCols, &options.boardRows) != 2) {
+                options.boardCols = -1;
+            }
+        }
+    }
+    if (options.tickRate < 0) {
+        std::cerr << "Invalid tick rate, using " << DEFAULT_TICK_RATE << std::endl;
+        options.tickRate = 0;
+    } else if (options.tickRate > MAX_TICK_RATE) {
+        std::cerr << "Tick rate too high, using " << MAX_TICK_RATE << std::endl;
+        options.tickRate = MAX_TICK_RATE;
     }
 
-    // 检查是否撞到自己
-    for (size_t i = 1; i < snake.size(); ++i) {
-        if (head.x == snake[i].x && head.y == snake[i].y) {
-            return true;
+    if (connectPort != 0) {
+        if (options.replay != nullptr || !options.autopilot.empty()) {
+            std::cerr << "--connect cannot be combined with --replay or --autopilot" << std::endl;
+            return 1;
         }
+        if (connectPort < 0 || connectPort > 65535 ||
+            !client.connect(static_cast<uint16_t>(connectPort), CONNECT_TIMEOUT_MS)) {
+            std::cerr << "Unable to join a server on port " << connectPort << std::endl;
+            return 1;
+        }
+        options.net = &client;
     }
 
-    return false;
-}
-
-bool SnakeGame::isButtonClicked(int x, int y, int btnX, int btnY, int btnW, int btnH) {
-    return x >= btnX && x <= btnX + btnW && y >= btnY && y <= btnY + btnH;
-}
+    if (options.net != nullptr) {
+        options.boardCols = client.mirror().cols();
+        options.boardRows = client.mirror().rows();
+    } else if (options.replay != nullptr) {
+        options.boardCols = replay.cols();
+        options.boardRows = replay.rows();
+    } else if (options.boardCols == 0 && options.boardRows == 0) {
+        options.boardCols = VIEW_COLS;
+        options.boardRows = VIEW_ROWS;
+    }
+    if (!validBoardSize(options.boardCols, options.boardRows)) {
+        std::cerr << "Invalid board size, expected WxH with " << MIN_BOARD_COLS << " <= W <= " << MAX_BOARD_SIDE
+                  << " and " << MIN_BOARD_ROWS << " <= H <= " << MAX_BOARD_SIDE << std::endl;
+        return 1;
+    }
 
-int main(int argc, char* argv[]) {
-    SnakeGame game;
+    SnakeGame game(options);
     game.run();
     return 0;
 }
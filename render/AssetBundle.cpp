@@ -0,0 +1,144 @@
+#include "AssetBundle.h"
+#include <iostream>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+AssetBundle::AssetBundle()
+        : data(nullptr), dataSize(0)
+#ifdef _WIN32
+        , fileHandle(nullptr), mappingHandle(nullptr)
+#endif
+{}
+
+AssetBundle::~AssetBundle() {
+    close();
+}
+
+bool AssetBundle::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    void* view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr) {
+        if (mapping != nullptr) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = static_cast<const uint8_t*>(view);
+    dataSize = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    data = static_cast<const uint8_t*>(view);
+    dataSize = static_cast<size_t>(info.st_size);
+#endif
+
+    // 校验文件头和每一项的范围，损坏的包整体放弃
+    const BundleHeader* header = reinterpret_cast<const BundleHeader*>(data);
+    bool valid = dataSize >= sizeof(BundleHeader) && std::memcmp(header->magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) == 0 &&
+                 header->version == BUNDLE_VERSION &&
+                 dataSize >= sizeof(BundleHeader) + static_cast<size_t>(header->count) * sizeof(BundleEntry);
+    for (uint32_t i = 0; valid && i < header->count; ++i) {
+        const BundleEntry* entry = reinterpret_cast<const BundleEntry*>(data + sizeof(BundleHeader)) + i;
+        // SDL 每行读 width * 4 字节，行距不能比它小，否则最后几行会读出这一项（乃至文件）的末尾
+        valid = entry->name[BUNDLE_NAME_SIZE - 1] == '\0' && entry->offset <= dataSize &&
+                entry->size <= dataSize - entry->offset && entry->format == BUNDLE_PIXEL_FORMAT &&
+                entry->width > 0 && entry->height > 0 && entry->pitch >= static_cast<uint64_t>(entry->width) * 4 &&
+                static_cast<uint64_t>(entry->pitch) * entry->height <= entry->size;
+    }
+    if (!valid) {
+        std::cerr << "Asset bundle " << path << " is corrupt or outdated" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void AssetBundle::close() {
+    if (data == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(data), dataSize);
+#endif
+    data = nullptr;
+    dataSize = 0;
+}
+
+const BundleEntry* AssetBundle::find(const std::string& name) const {
+    if (data == nullptr) {
+        return nullptr;
+    }
+    const BundleHeader* header = reinterpret_cast<const BundleHeader*>(data);
+    const BundleEntry* entries = reinterpret_cast<const BundleEntry*>(data + sizeof(BundleHeader));
+    for (uint32_t i = 0; i < header->count; ++i) {
+        if (name == entries[i].name) {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
+
+SDL_Surface* AssetBundle::surface(const std::string& name) const {
+    const BundleEntry* entry = find(name);
+    if (entry == nullptr) {
+        std::cerr << "Asset " << name << " not found in bundle" << std::endl;
+        return nullptr;
+    }
+    // 映射为只读，SDL 只会读取这块像素
+    return SDL_CreateRGBSurfaceWithFormatFrom(const_cast<uint8_t*>(data + entry->offset), entry->width,
+                                              entry->height, 32, entry->pitch, entry->format);
+}
+
+SDL_Texture* AssetBundle::texture(SDL_Renderer* renderer, const std::string& name) const {
+    const BundleEntry* entry = find(name);
+    if (entry == nullptr) {
+        std::cerr << "Asset " << name << " not found in bundle" << std::endl;
+        return nullptr;
+    }
+    SDL_Texture* newTexture = SDL_CreateTexture(renderer, entry->format, SDL_TEXTUREACCESS_STATIC, entry->width,
+                                                entry->height);
+    if (newTexture == nullptr) {
+        std::cerr << "Unable to create texture for " << name << "! SDL Error: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+    SDL_UpdateTexture(newTexture, nullptr, data + entry->offset, entry->pitch);
+    SDL_SetTextureBlendMode(newTexture, SDL_BLENDMODE_BLEND);
+    return newTexture;
+}
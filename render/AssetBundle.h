@@ -0,0 +1,61 @@
+#ifndef SNAKE_ASSET_BUNDLE_H
+#define SNAKE_ASSET_BUNDLE_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <string>
+
+// 资源包文件格式（小端）：
+//   BundleHeader
+//   BundleEntry × count
+//   像素数据，每张图按 BUNDLE_ALIGNMENT 对齐，已解码为可直接上传显卡的格式
+const char BUNDLE_MAGIC[8] = {'S', 'N', 'A', 'K', 'E', 'P', 'K', '1'};
+const uint32_t BUNDLE_VERSION = 1;
+const uint32_t BUNDLE_ALIGNMENT = 64;
+const int BUNDLE_NAME_SIZE = 32;
+// 包内像素一律为每像素 4 字节的 RGBA32
+const uint32_t BUNDLE_PIXEL_FORMAT = SDL_PIXELFORMAT_RGBA32;
+
+struct BundleHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+};
+
+struct BundleEntry {
+    char name[BUNDLE_NAME_SIZE];  // 以 '\0' 结尾的资源名，如 "background"
+    uint32_t width;
+    uint32_t height;
+    uint32_t pitch;
+    uint32_t format;              // SDL_PixelFormatEnum
+    uint64_t offset;              // 像素数据相对文件开头的偏移
+    uint64_t size;
+};
+
+// 只读映射一个资源包，纹理直接从映射的内存创建，不再逐张打开和解码 PNG
+class AssetBundle {
+public:
+    AssetBundle();
+    ~AssetBundle();
+
+    // 映射并校验资源包；失败时返回 false，调用方可退回逐张加载 PNG
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    const BundleEntry* find(const std::string& name) const;
+    // 直接引用映射内存的表面（不拷贝像素），须在 close() 之前释放
+    SDL_Surface* surface(const std::string& name) const;
+    // 从映射内存创建纹理
+    SDL_Texture* texture(SDL_Renderer* renderer, const std::string& name) const;
+
+private:
+    const uint8_t* data;
+    size_t dataSize;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
+
+#endif // SNAKE_ASSET_BUNDLE_H
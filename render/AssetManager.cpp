@@ -0,0 +1,122 @@
+#include "AssetManager.h"
+#include "Trace.h"
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <iostream>
+
+AssetManager::AssetManager() : nextJob(0), stopping(false), processed(0) {}
+
+AssetManager::~AssetManager() {
+    release();
+}
+
+void AssetManager::start(const AssetFile* files, int count, const std::string& bundlePath) {
+    release();
+    slots.clear();
+    for (int i = 0; i < count; ++i) {
+        slots.push_back({files[i], nullptr, nullptr, SLOT_PENDING});
+    }
+    decoded.clear();
+    processed = 0;
+    nextJob = 0;
+    stopping = false;
+
+    // 资源包只在这里打开一次，之后工作线程只读
+    bundle.open(bundlePath);
+
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, static_cast<unsigned int>(count));
+    for (unsigned int i = 0; i < threads; ++i) {
+        workers.push_back(std::thread(&AssetManager::worker, this));
+    }
+}
+
+void AssetManager::worker() {
+    SNAKE_TRACE_THREAD_NAME("asset worker");
+    // 加载中途退出时只等正在解码的图片，不再处理队列里剩下的
+    while (!stopping) {
+        int id = nextJob++;
+        if (id >= static_cast<int>(slots.size())) {
+            return;
+        }
+        SNAKE_TRACE_ZONE("decodeAsset");
+        const AssetFile& file = slots[id].file;
+        SDL_Surface* loaded = nullptr;
+        if (bundle.find(file.name) != nullptr) {
+            loaded = bundle.surface(file.name);
+        } else {
+            loaded = IMG_Load(file.path);
+            if (loaded == nullptr) {
+                std::cerr << "Unable to load image " << file.path << "! SDL_image Error: " << IMG_GetError()
+                          << std::endl;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        slots[id].surface = loaded;
+        slots[id].state = loaded != nullptr ? SLOT_DECODED : SLOT_FAILED;
+        decoded.push_back(id);
+    }
+}
+
+bool AssetManager::pump(SDL_Renderer* renderer) {
+    SNAKE_TRACE_ZONE("uploadTextures");
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        uploading.swap(decoded);
+    }
+    for (size_t k = 0; k < uploading.size(); ++k) {
+        Slot& slot = slots[uploading[k]];
+        if (slot.state == SLOT_DECODED) {
+            slot.texture = SDL_CreateTextureFromSurface(renderer, slot.surface);
+            if (slot.texture == nullptr) {
+                std::cerr << "Unable to create texture from " << slot.file.path << "! SDL Error: " << SDL_GetError()
+                          << std::endl;
+                slot.state = SLOT_FAILED;
+            } else {
+                slot.state = SLOT_READY;
+            }
+        }
+        ++processed;
+    }
+    uploading.clear();
+
+    if (finished()) {
+        joinWorkers();
+        return true;
+    }
+    return false;
+}
+
+float AssetManager::progress() const {
+    return slots.empty() ? 1.0f : static_cast<float>(processed) / slots.size();
+}
+
+void AssetManager::dropSurfaces() {
+    for (size_t i = 0; i < slots.size(); ++i) {
+        SDL_FreeSurface(slots[i].surface);
+        slots[i].surface = nullptr;
+    }
+}
+
+void AssetManager::release() {
+    // 先等工作线程退出，之后才能释放表面和关闭资源包
+    stopping = true;
+    joinWorkers();
+    dropSurfaces();
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i].texture != nullptr) {
+            SDL_DestroyTexture(slots[i].texture);
+            slots[i].texture = nullptr;
+        }
+    }
+    // 资源包里的表面直接引用映射内存，上面已全部释放
+    bundle.close();
+}
+
+void AssetManager::joinWorkers() {
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+    workers.clear();
+}
@@ -0,0 +1,62 @@
+#ifndef SNAKE_ASSET_MANAGER_H
+#define SNAKE_ASSET_MANAGER_H
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AssetBundle.h"
+#include "GameAssets.h"
+
+// 后台解码图片：工作线程并行把图片解码成 SDL_Surface，渲染线程每帧调用 pump() 上传为纹理
+// 单张图片失败只影响它自己，调用方按 nullptr 退回占位绘制
+class AssetManager {
+public:
+    AssetManager();
+    ~AssetManager();
+
+    // 开始加载；资源包可用时直接引用其中解码好的像素，否则在工作线程里解码 PNG
+    void start(const AssetFile* files, int count, const std::string& bundlePath);
+    // 在渲染线程调用：上传已解码的图片，全部处理完返回 true
+    bool pump(SDL_Renderer* renderer);
+
+    // 已处理的比例（0 到 1）
+    float progress() const;
+    bool finished() const { return processed == static_cast<int>(slots.size()); }
+
+    // 加载失败的资源返回 nullptr
+    SDL_Texture* texture(int id) const { return slots[id].texture; }
+    // 解码后的表面，调用 dropSurfaces() 之前有效
+    SDL_Surface* surface(int id) const { return slots[id].surface; }
+    void dropSurfaces();
+    // 让工作线程不再领取新图片并等它们退出，销毁表面和纹理后关闭资源包；
+    // 须在销毁 SDL_Renderer 和调用 IMG_Quit() 之前调用
+    void release();
+
+private:
+    enum SlotState { SLOT_PENDING, SLOT_DECODED, SLOT_READY, SLOT_FAILED };
+
+    struct Slot {
+        AssetFile file;
+        SDL_Surface* surface;
+        SDL_Texture* texture;
+        SlotState state;
+    };
+
+    void worker();
+    void joinWorkers();
+
+    std::vector<Slot> slots;
+    AssetBundle bundle;
+    std::vector<std::thread> workers;
+    std::atomic<int> nextJob;
+    std::atomic<bool> stopping;  // release() 已开始，工作线程不再领取新图片
+    std::mutex mutex;
+    std::vector<int> decoded;  // 已解码、等待上传的资源，受 mutex 保护
+    std::vector<int> uploading;
+    int processed;             // 渲染线程已处理（上传或失败）的数量
+};
+
+#endif // SNAKE_ASSET_MANAGER_H
@@ -0,0 +1,146 @@
+#include "FrameStats.h"
+#include <algorithm>
+#include <cstdio>
+
+// 面板字体：3x5 点阵，每行 3 位，高位在左
+static const int GLYPH_SCALE = 2;
+static const int GLYPH_ADVANCE = 4 * GLYPH_SCALE;
+static const int LINE_HEIGHT = 7 * GLYPH_SCALE;
+
+static unsigned int glyphBits(char c) {
+    switch (c) {
+        case '0': return 0x7B6F;  // 111 101 101 101 111
+        case '1': return 0x2C97;  // 010 110 010 010 111
+        case '2': return 0x73E7;  // 111 001 111 100 111
+        case '3': return 0x73CF;  // 111 001 111 001 111
+        case '4': return 0x5BC9;  // 101 101 111 001 001
+        case '5': return 0x79CF;  // 111 100 111 001 111
+        case '6': return 0x79EF;  // 111 100 111 101 111
+        case '7': return 0x7249;  // 111 001 001 001 001
+        case '8': return 0x7BEF;  // 111 101 111 101 111
+        case '9': return 0x7BCF;  // 111 101 111 001 111
+        case '.': return 0x0002;  // 000 000 000 000 010
+        case 'A': return 0x2BED;  // 010 101 111 101 101
+        case 'D': return 0x6B6E;  // 110 101 101 101 110
+        case 'F': return 0x79A4;  // 111 100 110 100 100
+        case 'I': return 0x7497;  // 111 010 010 010 111
+        case 'M': return 0x5FED;  // 101 111 111 101 101
+        case 'N': return 0x6B6D;  // 110 101 101 101 101
+        case 'P': return 0x6BA4;  // 110 101 110 100 100
+        case 'R': return 0x6BAD;  // 110 101 110 101 101
+        case 'S': return 0x388E;  // 011 100 010 001 110
+        case 'U': return 0x5B6F;  // 101 101 101 101 111
+        case 'X': return 0x5AAD;  // 101 101 010 101 101
+        default: return 0;
+    }
+}
+
+// 把一行文字的点阵追加为矩形
+static void appendText(std::vector<SDL_Rect>& rects, const char* text, int x, int y) {
+    for (; *text != '\0'; ++text, x += GLYPH_ADVANCE) {
+        unsigned int bits = glyphBits(*text);
+        for (int row = 0; row < 5; ++row) {
+            for (int col = 0; col < 3; ++col) {
+                if (bits & (1u << (14 - row * 3 - col))) {
+                    rects.push_back({x + col * GLYPH_SCALE, y + row * GLYPH_SCALE, GLYPH_SCALE, GLYPH_SCALE});
+                }
+            }
+        }
+    }
+}
+
+FrameStats::FrameStats() : frames(0), recentHead(0), overlayRefreshedAt(0) {
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        recent[phase].reserve(WINDOW);
+        for (int k = 0; k < 4; ++k) {
+            overlayValues[phase][k] = 0.0f;
+        }
+    }
+}
+
+void FrameStats::addFrame(const float (&phaseMs)[PHASE_COUNT]) {
+    if (csv.is_open()) {
+        csv << frames;
+        for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+            csv << ',' << phaseMs[phase];
+        }
+        csv << '\n';
+    }
+    ++frames;
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        if (static_cast<int>(recent[phase].size()) < WINDOW) {
+            recent[phase].push_back(phaseMs[phase]);
+        } else {
+            recent[phase][recentHead] = phaseMs[phase];
+        }
+    }
+    if (static_cast<int>(recent[0].size()) == WINDOW) {
+        recentHead = (recentHead + 1) % WINDOW;
+    }
+}
+
+float FrameStats::percentile(Phase phase, float p) const {
+    if (recent[phase].empty()) {
+        return 0.0f;
+    }
+    std::vector<float> sorted(recent[phase]);
+    size_t rank = std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
+
+float FrameStats::maximum(Phase phase) const {
+    if (recent[phase].empty()) {
+        return 0.0f;
+    }
+    return *std::max_element(recent[phase].begin(), recent[phase].end());
+}
+
+void FrameStats::drawOverlay(SDL_Renderer* renderer, int x, int y) {
+    static const char* const labels[PHASE_COUNT] = {"INP", "UPD", "RND", "PRS", "FRM"};
+
+    // 每 250 毫秒刷新一次数值
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (now - overlayRefreshedAt > SDL_GetPerformanceFrequency() / 4) {
+        overlayRefreshedAt = now;
+        for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+            overlayValues[phase][0] = percentile(static_cast<Phase>(phase), 0.50f);
+            overlayValues[phase][1] = percentile(static_cast<Phase>(phase), 0.95f);
+            overlayValues[phase][2] = percentile(static_cast<Phase>(phase), 0.99f);
+            overlayValues[phase][3] = maximum(static_cast<Phase>(phase));
+        }
+    }
+
+    glyphRects.clear();
+    appendText(glyphRects, "       P50    P95    P99    MAX", x + 4, y + 4);
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        char line[64];
+        std::snprintf(line, sizeof(line), "%s %6.2f %6.2f %6.2f %6.2f", labels[phase], overlayValues[phase][0],
+                      overlayValues[phase][1], overlayValues[phase][2], overlayValues[phase][3]);
+        appendText(glyphRects, line, x + 4, y + 4 + (phase + 1) * LINE_HEIGHT);
+    }
+
+    SDL_Rect panel = {x, y, 31 * GLYPH_ADVANCE + 8, (PHASE_COUNT + 1) * LINE_HEIGHT + 6};
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 160);
+    SDL_RenderFillRect(renderer, &panel);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
+    SDL_RenderFillRects(renderer, glyphRects.data(), static_cast<int>(glyphRects.size()));
+}
+
+bool FrameStats::openCsv(const std::string& path) {
+    csv.open(path.c_str());
+    if (!csv) {
+        return false;
+    }
+    csv << "frame,input_ms,update_ms,render_ms,present_ms,frame_ms\n";
+    return true;
+}
+
+bool FrameStats::closeCsv() {
+    csv.flush();
+    bool ok = static_cast<bool>(csv);
+    csv.close();
+    return ok;
+}
@@ -0,0 +1,47 @@
+#ifndef SNAKE_FRAME_STATS_H
+#define SNAKE_FRAME_STATS_H
+
+#include <SDL2/SDL.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// 每帧各阶段耗时统计：保留最近若干帧计算 p50/p95/p99/max，可叠加显示在画面上；
+// 每帧的样本随帧逐行写入 CSV，内存占用不随运行时长增长
+class FrameStats {
+public:
+    enum Phase { PHASE_INPUT, PHASE_UPDATE, PHASE_RENDER, PHASE_PRESENT, PHASE_FRAME, PHASE_COUNT };
+
+    FrameStats();
+
+    // 记录一帧的各阶段耗时（毫秒），顺序同 Phase
+    void addFrame(const float (&phaseMs)[PHASE_COUNT]);
+    // 最近 WINDOW 帧中某阶段的分位数（0 到 1）
+    float percentile(Phase phase, float p) const;
+    float maximum(Phase phase) const;
+
+    // 在 (x, y) 处画半透明面板，每行一个阶段：p50 p95 p99 max
+    void drawOverlay(SDL_Renderer* renderer, int x, int y);
+    // 开始把之后每帧的样本逐行写入 CSV；文件打不开时返回 false
+    bool openCsv(const std::string& path);
+    // 写完并关闭 CSV；写入中途出过错时返回 false
+    bool closeCsv();
+    bool csvOpen() const { return csv.is_open(); }
+
+    long long frameCount() const { return frames; }
+
+private:
+    static const int WINDOW = 1024;
+
+    long long frames;
+    std::ofstream csv;                        // 文件流自带缓冲，每帧只追加一行
+    std::vector<float> recent[PHASE_COUNT];   // 最近 WINDOW 帧（环形）
+    int recentHead;
+
+    // 面板内容每隔一段时间才重新计算，避免每帧排序
+    Uint64 overlayRefreshedAt;
+    float overlayValues[PHASE_COUNT][4];
+    std::vector<SDL_Rect> glyphRects;
+};
+
+#endif // SNAKE_FRAME_STATS_H
@@ -0,0 +1,33 @@
+#ifndef SNAKE_GAME_ASSETS_H
+#define SNAKE_GAME_ASSETS_H
+
+// 游戏用到的全部图片
+enum GameAsset {
+    ASSET_BACKGROUND,
+    ASSET_START_BUTTON,
+    ASSET_SETTING_BUTTON,
+    ASSET_SNAKE_HEAD,
+    ASSET_SNAKE_BODY,
+    ASSET_SNAKE_TAIL,
+    ASSET_COUNT
+};
+
+// 资源名（资源包中的键）与原始 PNG 路径，顺序同 GameAsset
+struct AssetFile {
+    const char* name;
+    const char* path;
+};
+
+const AssetFile GAME_ASSETS[ASSET_COUNT] = {
+        {"background", "picture\\background.png"},
+        {"startbutton", "picture\\startbutton.png"},
+        {"setting", "picture\\setting.png"},
+        {"Snakehead", "picture\\Snakehead.png"},
+        {"Snakebody", "picture\\Snakebody.png"},
+        {"Snaketail", "picture\\Snaketail.png"},
+};
+
+// SnakePack 生成的资源包，存在时优先使用
+const char* const GAME_BUNDLE_PATH = "picture\\assets.pak";
+
+#endif // SNAKE_GAME_ASSETS_H
@@ -0,0 +1,369 @@
+#include "SnakeRenderer.h"
+#include "NetProtocol.h"
+#include <iostream>
+#include <algorithm>
+
+// 图集中每个槽位的边长（像素）
+static const int ATLAS_SLOT_SIZE = 64;
+// 图集每行的槽位数
+static const int ATLAS_COLUMNS = 4;
+
+// 边长为 ATLAS_SLOT_SIZE 的 RGBA32 贴图中，顺时针转 turns 个 90 度后 (x, y) 处的像素
+static const Uint8* rotatedPixel(SDL_Surface* tile, int turns, int x, int y) {
+    for (int k = 0; k < (turns & 3); ++k) {
+        int sx = y;
+        int sy = ATLAS_SLOT_SIZE - 1 - x;
+        x = sx;
+        y = sy;
+    }
+    return static_cast<const Uint8*>(tile->pixels) + y * tile->pitch + x * 4;
+}
+
+// 把贴图缩放成一个槽位大小的 RGBA32 表面；贴图缺失时用纯色方块代替
+static SDL_Surface* scaledTile(SDL_Surface* sprite, Uint8 r, Uint8 g, Uint8 b) {
+    SDL_Surface* tile = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_SLOT_SIZE, ATLAS_SLOT_SIZE, 32, SDL_PIXELFORMAT_RGBA32);
+    if (tile == nullptr) {
+        return nullptr;
+    }
+    if (sprite == nullptr) {
+        SDL_FillRect(tile, nullptr, SDL_MapRGBA(tile->format, r, g, b, 255));
+        return tile;
+    }
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(sprite, SDL_PIXELFORMAT_RGBA32, 0);
+    if (converted == nullptr) {
+        SDL_FreeSurface(tile);
+        return nullptr;
+    }
+    SDL_FillRect(tile, nullptr, 0);
+    SDL_SetSurfaceBlendMode(converted, SDL_BLENDMODE_NONE);
+    SDL_BlitScaled(converted, nullptr, tile, nullptr);
+    SDL_FreeSurface(converted);
+    return tile;
+}
+
+// 槽位左上角在图集中的像素位置
+static Uint8* slotPixels(SDL_Surface* sheet, int slot) {
+    return static_cast<Uint8*>(sheet->pixels) + (slot / ATLAS_COLUMNS) * ATLAS_SLOT_SIZE * sheet->pitch +
+           (slot % ATLAS_COLUMNS) * ATLAS_SLOT_SIZE * 4;
+}
+
+// 把贴图转好方向写进图集的槽位
+static void writeRotated(SDL_Surface* sheet, int slot, SDL_Surface* tile, int turns) {
+    Uint8* dst = slotPixels(sheet, slot);
+    for (int y = 0; y < ATLAS_SLOT_SIZE; ++y) {
+        for (int x = 0; x < ATLAS_SLOT_SIZE; ++x) {
+            const Uint8* src = rotatedPixel(tile, turns, x, y);
+            std::copy(src, src + 4, dst + y * sheet->pitch + x * 4);
+        }
+    }
+}
+
+// 用横向蛇身拼出拐角：靠近水平出口的半边取横段，靠近竖直出口的半边取竖段，重叠处取更不透明的像素
+static void writeCorner(SDL_Surface* sheet, int slot, SDL_Surface* body, Direction vertical, Direction horizontal) {
+    const int half = ATLAS_SLOT_SIZE / 2;
+    Uint8* dst = slotPixels(sheet, slot);
+    for (int y = 0; y < ATLAS_SLOT_SIZE; ++y) {
+        for (int x = 0; x < ATLAS_SLOT_SIZE; ++x) {
+            bool nearHorizontal = horizontal == LEFT ? x < half : x >= half;
+            bool nearVertical = vertical == UP ? y < half : y >= half;
+            static const Uint8 transparent[4] = {0, 0, 0, 0};
+            const Uint8* pixel = transparent;
+            if (nearHorizontal) {
+                pixel = rotatedPixel(body, 0, x, y);
+            }
+            if (nearVertical) {
+                const Uint8* verticalPixel = rotatedPixel(body, 1, x, y);
+                if (verticalPixel[3] > pixel[3]) {
+                    pixel = verticalPixel;
+                }
+            }
+            std::copy(pixel, pixel + 4, dst + y * sheet->pitch + x * 4);
+        }
+    }
+}
+
+// 蛇头、蛇尾贴图朝左，朝各方向需要顺时针旋转的 90 度次数（顺序同 Direction）
+static const int TURNS_FOR_DIRECTION[4] = {1, 3, 0, 2};
+
+SnakeRenderer::SnakeRenderer()
+        : atlas(nullptr), playfield(nullptr), playfieldWidth(0), playfieldHeight(0), fullRedraw(true) {}
+
+SnakeRenderer::~SnakeRenderer() {
+    release();
+}
+
+void SnakeRenderer::release() {
+    if (atlas != nullptr) {
+        SDL_DestroyTexture(atlas);
+        atlas = nullptr;
+    }
+    if (playfield != nullptr) {
+        SDL_DestroyTexture(playfield);
+        playfield = nullptr;
+    }
+}
+
+bool SnakeRenderer::buildAtlas(SDL_Renderer* renderer, SDL_Surface* head, SDL_Surface* body, SDL_Surface* tail) {
+    const int atlasRows = (SLOT_COUNT + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS;
+    SDL_Surface* sheet = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_SLOT_SIZE * ATLAS_COLUMNS,
+                                                        ATLAS_SLOT_SIZE * atlasRows, 32, SDL_PIXELFORMAT_RGBA32);
+    SDL_Surface* headTile = scaledTile(head, 0, 120, 0);
+    SDL_Surface* bodyTile = scaledTile(body, 0, 180, 0);
+    SDL_Surface* tailTile = scaledTile(tail, 120, 220, 120);
+    if (sheet == nullptr || headTile == nullptr || bodyTile == nullptr || tailTile == nullptr) {
+        std::cerr << "Unable to prepare atlas surfaces! SDL Error: " << SDL_GetError() << std::endl;
+        SDL_FreeSurface(sheet);
+        SDL_FreeSurface(headTile);
+        SDL_FreeSurface(bodyTile);
+        SDL_FreeSurface(tailTile);
+        return false;
+    }
+    SDL_FillRect(sheet, nullptr, 0);
+
+    // 载入时一次性生成所有朝向，绘制时不再旋转
+    for (int d = 0; d < 4; ++d) {
+        writeRotated(sheet, SLOT_HEAD + d, headTile, TURNS_FOR_DIRECTION[d]);
+        writeRotated(sheet, SLOT_TAIL + d, tailTile, TURNS_FOR_DIRECTION[d]);
+    }
+    writeRotated(sheet, SLOT_BODY_HORIZONTAL, bodyTile, 0);
+    writeRotated(sheet, SLOT_BODY_VERTICAL, bodyTile, 1);
+    writeCorner(sheet, SLOT_CORNER_UP_LEFT, bodyTile, UP, LEFT);
+    writeCorner(sheet, SLOT_CORNER_UP_RIGHT, bodyTile, UP, RIGHT);
+    writeCorner(sheet, SLOT_CORNER_DOWN_LEFT, bodyTile, DOWN, LEFT);
+    writeCorner(sheet, SLOT_CORNER_DOWN_RIGHT, bodyTile, DOWN, RIGHT);
+    SDL_FreeSurface(headTile);
+    SDL_FreeSurface(bodyTile);
+    SDL_FreeSurface(tailTile);
+
+    // 食物：红色方块
+    SDL_Rect foodRect = {(SLOT_FOOD % ATLAS_COLUMNS) * ATLAS_SLOT_SIZE, (SLOT_FOOD / ATLAS_COLUMNS) * ATLAS_SLOT_SIZE,
+                         ATLAS_SLOT_SIZE, ATLAS_SLOT_SIZE};
+    SDL_FillRect(sheet, &foodRect, SDL_MapRGBA(sheet->format, 255, 0, 0, 255));
+
+    if (atlas != nullptr) {
+        SDL_DestroyTexture(atlas);
+    }
+    atlas = SDL_CreateTextureFromSurface(renderer, sheet);
+    SDL_FreeSurface(sheet);
+    if (atlas == nullptr) {
+        std::cerr << "Unable to create atlas texture! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+void SnakeRenderer::pushQuad(int slot, float x, float y, float size) {
+    // 纹理坐标内缩半个像素，避免线性过滤时采到相邻槽位
+    const int atlasRows = (SLOT_COUNT + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS;
+    const float atlasWidth = static_cast<float>(ATLAS_SLOT_SIZE * ATLAS_COLUMNS);
+    const float atlasHeight = static_cast<float>(ATLAS_SLOT_SIZE * atlasRows);
+    int left = (slot % ATLAS_COLUMNS) * ATLAS_SLOT_SIZE;
+    int top = (slot / ATLAS_COLUMNS) * ATLAS_SLOT_SIZE;
+    float u0 = (left + 0.5f) / atlasWidth;
+    float u1 = (left + ATLAS_SLOT_SIZE - 0.5f) / atlasWidth;
+    float v0 = (top + 0.5f) / atlasHeight;
+    float v1 = (top + ATLAS_SLOT_SIZE - 0.5f) / atlasHeight;
+    const SDL_FPoint corners[4] = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+    const SDL_FPoint positions[4] = {{x, y}, {x + size, y}, {x + size, y + size}, {x, y + size}};
+
+    int base = static_cast<int>(vertices.size());
+    for (int k = 0; k < 4; ++k) {
+        SDL_Vertex vertex;
+        vertex.position = positions[k];
+        vertex.color = {255, 255, 255, 255};
+        vertex.tex_coord = corners[k];
+        vertices.push_back(vertex);
+    }
+    const int pattern[6] = {0, 1, 2, 0, 2, 3};
+    for (int k = 0; k < 6; ++k) {
+        indices.push_back(base + pattern[k]);
+    }
+}
+
+void SnakeRenderer::pushSegment(const SnakeBody& snake, int i, Direction headDir, float x, float y, float size) {
+    const Position& cell = snake[i];
+    pushPiece(i, snake.size(), headDir, i > 0 ? snake[i - 1] : cell, cell, i + 1 < snake.size() ? snake[i + 1] : cell,
+              x, y, size);
+}
+
+void SnakeRenderer::pushPiece(int i, int count, Direction headDir, Position previous, Position cell, Position next,
+                              float x, float y, float size) {
+    if (i == 0) {
+        // 蛇头：按前进方向
+        pushQuad(SLOT_HEAD + headDir, x, y, size);
+    } else if (i == count - 1) {
+        // 蛇尾：朝向靠近蛇头的一段
+        pushQuad(SLOT_TAIL + directionTo(cell, previous), x, y, size);
+    } else {
+        // 蛇身：按前后两节所在方向查表，直段或拐角
+        // 查找表下标为 [指向前一节的方向][指向后一节的方向]
+        static const int BODY_SLOTS[4][4] = {
+                {SLOT_BODY_VERTICAL, SLOT_BODY_VERTICAL, SLOT_CORNER_UP_LEFT, SLOT_CORNER_UP_RIGHT},
+                {SLOT_BODY_VERTICAL, SLOT_BODY_VERTICAL, SLOT_CORNER_DOWN_LEFT, SLOT_CORNER_DOWN_RIGHT},
+                {SLOT_CORNER_UP_LEFT, SLOT_CORNER_DOWN_LEFT, SLOT_BODY_HORIZONTAL, SLOT_BODY_HORIZONTAL},
+                {SLOT_CORNER_UP_RIGHT, SLOT_CORNER_DOWN_RIGHT, SLOT_BODY_HORIZONTAL, SLOT_BODY_HORIZONTAL},
+        };
+        pushQuad(BODY_SLOTS[directionTo(cell, previous)][directionTo(cell, next)], x, y, size);
+    }
+}
+
+void SnakeRenderer::draw(SDL_Renderer* renderer, const SnakeBody& snake, Direction headDir, Position food,
+                         int cellSize, int originX, int originY) {
+    vertices.clear();
+    indices.clear();
+    const float size = static_cast<float>(cellSize);
+
+    for (int i = 0; i < snake.size(); ++i) {
+        pushSegment(snake, i, headDir, static_cast<float>(originX + snake[i].x * cellSize),
+                    static_cast<float>(originY + snake[i].y * cellSize), size);
+    }
+
+    // 食物
+    pushQuad(SLOT_FOOD, static_cast<float>(originX + food.x * cellSize),
+             static_cast<float>(originY + food.y * cellSize), size);
+
+    SDL_RenderGeometry(renderer, atlas, vertices.data(), static_cast<int>(vertices.size()),
+                       indices.data(), static_cast<int>(indices.size()));
+}
+
+void SnakeRenderer::drawView(SDL_Renderer* renderer, const SnakeBody& snake, Direction headDir, Position food,
+                             const OccupancyGrid& occupied, const CellSlotMap& slots, const SDL_Rect& view,
+                             int cellSize) {
+    vertices.clear();
+    indices.clear();
+    const float size = static_cast<float>(cellSize);
+
+    for (int y = view.y; y < view.y + view.h; ++y) {
+        for (int x = view.x; x < view.x + view.w; ++x) {
+            if (!occupied.inside(x, y) || !occupied.test(x, y)) {
+                continue;
+            }
+            pushSegment(snake, snake.indexOfSlot(slots.get({x, y})), headDir,
+                        static_cast<float>((x - view.x) * cellSize), static_cast<float>((y - view.y) * cellSize), size);
+        }
+    }
+    if (food.x >= view.x && food.x < view.x + view.w && food.y >= view.y && food.y < view.y + view.h) {
+        pushQuad(SLOT_FOOD, static_cast<float>((food.x - view.x) * cellSize),
+                 static_cast<float>((food.y - view.y) * cellSize), size);
+    }
+
+    if (!indices.empty()) {
+        SDL_RenderGeometry(renderer, atlas, vertices.data(), static_cast<int>(vertices.size()),
+                           indices.data(), static_cast<int>(indices.size()));
+    }
+}
+
+void SnakeRenderer::drawWorld(SDL_Renderer* renderer, const NetMirror& world, const SDL_Rect& view, int cellSize) {
+    vertices.clear();
+    indices.clear();
+    const float size = static_cast<float>(cellSize);
+    auto visible = [&view](Position p) {
+        return p.x >= view.x && p.x < view.x + view.w && p.y >= view.y && p.y < view.y + view.h;
+    };
+
+    // 联机棋盘不大，逐节检查是否在视口内
+    for (int s = 0; s < world.snakeCount(); ++s) {
+        const int count = world.length(s);
+        if (count == 0) continue;
+        const Direction headDir = world.direction(s);
+        for (int i = 0; i < count; ++i) {
+            Position cell = world.segment(s, i);
+            if (!visible(cell)) continue;
+            pushPiece(i, count, headDir, i > 0 ? world.segment(s, i - 1) : cell, cell,
+                      i + 1 < count ? world.segment(s, i + 1) : cell, static_cast<float>((cell.x - view.x) * cellSize),
+                      static_cast<float>((cell.y - view.y) * cellSize), size);
+        }
+    }
+    for (int k = 0; k < world.foodCount(); ++k) {
+        Position food = world.food(k);
+        if (visible(food)) {
+            pushQuad(SLOT_FOOD, static_cast<float>((food.x - view.x) * cellSize),
+                     static_cast<float>((food.y - view.y) * cellSize), size);
+        }
+    }
+
+    if (!indices.empty()) {
+        SDL_RenderGeometry(renderer, atlas, vertices.data(), static_cast<int>(vertices.size()),
+                           indices.data(), static_cast<int>(indices.size()));
+    }
+}
+
+bool SnakeRenderer::enableIncremental(SDL_Renderer* renderer, int width, int height) {
+    if (playfield != nullptr) {
+        SDL_DestroyTexture(playfield);
+        playfield = nullptr;
+    }
+    fullRedraw = true;
+    if (!SDL_RenderTargetSupported(renderer)) {
+        return false;
+    }
+    playfield = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (playfield == nullptr) {
+        std::cerr << "Unable to create playfield texture! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    playfieldWidth = width;
+    playfieldHeight = height;
+    return true;
+}
+
+bool SnakeRenderer::isDirty(Position cell) const {
+    for (size_t k = 0; k < dirtyCells.size(); ++k) {
+        if (dirtyCells[k] == cell) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SnakeRenderer::drawIncremental(SDL_Renderer* renderer, const SnakeBody& snake, Direction headDir, Position food,
+                                    int cellSize) {
+    if (playfield == nullptr) {
+        dirtyCells.clear();
+        draw(renderer, snake, headDir, food, cellSize, 0, 0);
+        return;
+    }
+
+    SDL_SetRenderTarget(renderer, playfield);
+    if (fullRedraw) {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        draw(renderer, snake, headDir, food, cellSize, 0, 0);
+        fullRedraw = false;
+    } else if (!dirtyCells.empty()) {
+        // 先把变动的格子涂回背景色
+        dirtyRects.clear();
+        for (size_t k = 0; k < dirtyCells.size(); ++k) {
+            dirtyRects.push_back({dirtyCells[k].x * cellSize, dirtyCells[k].y * cellSize, cellSize, cellSize});
+        }
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderFillRects(renderer, dirtyRects.data(), static_cast<int>(dirtyRects.size()));
+
+        // 变动只会出现在蛇头附近、蛇尾附近和食物处；每一步最多让蛇头一侧多出一节，
+        // 因此只需检查前 dirtyCells.size() + 1 节和最后两节
+        vertices.clear();
+        indices.clear();
+        const float size = static_cast<float>(cellSize);
+        int headEnd = std::min(snake.size(), static_cast<int>(dirtyCells.size()) + 1);
+        int tailBegin = std::max(headEnd, snake.size() - 2);
+        for (int i = 0; i < snake.size(); i = (i + 1 == headEnd ? tailBegin : i + 1)) {
+            if (isDirty(snake[i])) {
+                pushSegment(snake, i, headDir, static_cast<float>(snake[i].x * cellSize),
+                            static_cast<float>(snake[i].y * cellSize), size);
+            }
+        }
+        if (isDirty(food)) {
+            pushQuad(SLOT_FOOD, static_cast<float>(food.x * cellSize), static_cast<float>(food.y * cellSize), size);
+        }
+        if (!indices.empty()) {
+            SDL_RenderGeometry(renderer, atlas, vertices.data(), static_cast<int>(vertices.size()),
+                               indices.data(), static_cast<int>(indices.size()));
+        }
+    }
+    dirtyCells.clear();
+    SDL_SetRenderTarget(renderer, nullptr);
+
+    SDL_Rect dst = {0, 0, playfieldWidth, playfieldHeight};
+    SDL_RenderCopy(renderer, playfield, nullptr, &dst);
+}
@@ -0,0 +1,92 @@
+#ifndef SNAKE_RENDERER_H
+#define SNAKE_RENDERER_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "Board.h"
+
+class NetMirror;
+
+// 蛇与食物的批量绘制：所有贴图打包进一张图集，整条蛇加食物每帧只提交一次 SDL_RenderGeometry
+class SnakeRenderer {
+public:
+    SnakeRenderer();
+    ~SnakeRenderer();
+
+    // 用蛇头、蛇身、蛇尾三张图生成图集：蛇头、蛇尾预先旋转出四个朝向，
+    // 蛇身生成横、竖两种直段和四种拐角，食物格直接填成红色；缺失的贴图用纯色方块代替
+    bool buildAtlas(SDL_Renderer* renderer, SDL_Surface* head, SDL_Surface* body, SDL_Surface* tail);
+    // 释放图集纹理，须在销毁 SDL_Renderer 之前调用
+    void release();
+    // 按格子坐标绘制，(originX, originY) 为棋盘左上角的像素位置
+    void draw(SDL_Renderer* renderer, const SnakeBody& snake, Direction headDir, Position food,
+              int cellSize, int originX, int originY);
+    // 只画视口 view（以格子为单位）内的部分，视口左上角对齐屏幕左上角；逐格查占用位图和 CellSlotMap，
+    // 开销只与视口面积有关，与蛇长无关
+    void drawView(SDL_Renderer* renderer, const SnakeBody& snake, Direction headDir, Position food,
+                  const OccupancyGrid& occupied, const CellSlotMap& slots, const SDL_Rect& view, int cellSize);
+    // 联机画面：服务器快照还原出的所有蛇和食物，只画视口 view 内的格子，仍然只提交一次
+    void drawWorld(SDL_Renderer* renderer, const NetMirror& world, const SDL_Rect& view, int cellSize);
+
+    // 增量模式：棋盘画在常驻的渲染目标纹理上，每帧只重画标记过的格子再整张拷到屏幕
+    // 渲染器不支持渲染目标时返回 false，drawIncremental() 退化为整体重画
+    bool enableIncremental(SDL_Renderer* renderer, int width, int height);
+    // 下一帧整体重画（窗口尺寸变化、渲染目标丢失、游戏状态切换时调用）
+    void invalidate() { fullRedraw = true; }
+    // 标记内容发生变化的格子；攒够 MAX_DIRTY_CELLS 格后改为下一帧整体重画
+    void markDirty(Position cell) {
+        if (fullRedraw) {
+            return;
+        }
+        if (dirtyCells.size() >= MAX_DIRTY_CELLS) {
+            dirtyCells.clear();
+            fullRedraw = true;
+            return;
+        }
+        dirtyCells.push_back(cell);
+    }
+    void drawIncremental(SDL_Renderer* renderer, const SnakeBody& snake, Direction headDir, Position food,
+                         int cellSize);
+
+private:
+    // 图集中的槽位；蛇头按前进方向、蛇尾按指向相邻一节的方向各占四格（顺序同 Direction）
+    enum AtlasSlot {
+        SLOT_HEAD = 0,
+        SLOT_TAIL = 4,
+        SLOT_BODY_HORIZONTAL = 8,
+        SLOT_BODY_VERTICAL,
+        SLOT_CORNER_UP_LEFT,
+        SLOT_CORNER_UP_RIGHT,
+        SLOT_CORNER_DOWN_LEFT,
+        SLOT_CORNER_DOWN_RIGHT,
+        SLOT_FOOD,
+        SLOT_COUNT
+    };
+
+    // 追加一个格子的四个顶点，贴图已预先转好方向，直接按原样贴
+    void pushQuad(int slot, float x, float y, float size);
+    // 追加第 i 节蛇身
+    void pushSegment(const SnakeBody& snake, int i, Direction headDir, float x, float y, float size);
+    // 追加共 count 节中的第 i 节，previous、next 为前后两节（蛇头、蛇尾缺的一侧不读）
+    void pushPiece(int i, int count, Direction headDir, Position previous, Position cell, Position next, float x,
+                   float y, float size);
+    bool isDirty(Position cell) const;
+
+    // 每步标记 6 格，卡顿后补算几步时仍走增量；再多时逐格线性查找和逐格涂背景
+    // 比整体重画还慢
+    static const size_t MAX_DIRTY_CELLS = 48;
+
+    SDL_Texture* atlas;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+
+    // 增量模式使用的常驻棋盘纹理
+    SDL_Texture* playfield;
+    int playfieldWidth;
+    int playfieldHeight;
+    bool fullRedraw;
+    std::vector<Position> dirtyCells;
+    std::vector<SDL_Rect> dirtyRects;
+};
+
+#endif // SNAKE_RENDERER_H
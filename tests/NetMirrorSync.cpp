@@ -0,0 +1,383 @@
+// 联机快照的测试：服务器端 Arena + SnapshotHistory 与多个 NetMirror 客户端
+// 1. 客户端的链路有丢包、乱序，确认也会丢、会落后或回到 -1；客户端每跟上一步都逐格比较蛇、归属与食物
+// 2. 截断的包、手工构造的坏包（计数溢出、越界、超长的变长整数等）必须被 apply() 拒绝，
+//    棋盘尺寸不合法的加入回复必须被 readWelcome() 拒绝；
+//    随机翻转若干位的包不能让客户端崩溃，之后的完整快照必须能把局面恢复一致
+// 用法：NetMirrorSync [--steps N]；有不一致时打印第一处并返回 1
+#include "NetProtocol.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct SyncConfig {
+    int cols;
+    int rows;
+    int snakes;
+    int foods;
+    unsigned int seed;
+};
+
+const SyncConfig SYNC_CONFIGS[] = {
+    {40, 30, 4, 1, 1},
+    {16, 12, 9, 8, 2},
+    {40, 12, 14, 15, 3},
+    // 蛇多、食物多的小棋盘：频繁相撞、重新放置，同一格的食物常在两次确认之间被吃掉又放上
+    {16, 30, 19, 22, 4},
+    {40, 30, 24, 29, 5},
+};
+
+// 各客户端的丢包率（百分比）；第一个不丢包、不乱序，应每步都跟上
+const int LOSS_PERCENT[] = {0, 0, 15, 30, 45, 60};
+const int CLIENT_COUNT = sizeof(LOSS_PERCENT) / sizeof(LOSS_PERCENT[0]);
+// 在途的包超过这么多时整体丢掉，模拟长时间断线
+const size_t MAX_IN_FLIGHT = 100;
+
+bool sameState(const Arena& arena, const NetMirror& mirror) {
+    for (int i = 0; i < arena.snakeCount(); ++i) {
+        if (arena.isAlive(i) != mirror.isAlive(i)) return false;
+        if (!arena.isAlive(i)) continue;
+        if (arena.length(i) != mirror.length(i) || arena.direction(i) != mirror.direction(i)) return false;
+        for (int k = 0; k < arena.length(i); ++k) {
+            if (arena.segment(i, k) != mirror.segment(i, k)) return false;
+        }
+    }
+    for (int y = 0; y < arena.rows(); ++y) {
+        for (int x = 0; x < arena.cols(); ++x) {
+            Position p = {x, y};
+            if (arena.ownerAt(p) != mirror.ownerAt(p) || arena.hasFood(p) != mirror.hasFood(p)) return false;
+        }
+    }
+    return arena.foodCount() == mirror.foodCount();
+}
+
+struct Client {
+    NetMirror mirror;
+    long long ack;
+    std::vector<std::vector<uint8_t>> inFlight;
+};
+
+bool runSync(const SyncConfig& config, long long steps, long long& checks) {
+    Arena arena(config.cols, config.rows, config.snakes, config.foods, config.seed);
+    SnapshotHistory history;
+    history.start(arena);
+    std::vector<Client> clients(CLIENT_COUNT);
+    for (Client& client : clients) {
+        client.mirror.setup(config.cols, config.rows, config.snakes);
+        client.ack = -1;
+    }
+    Rng rng(config.seed * 7919u);
+    std::vector<Direction> actions(config.snakes);
+    std::vector<StepResult> results(config.snakes);
+    std::vector<uint8_t> packet;
+
+    for (long long t = 0; t < steps; ++t) {
+        // 两步之间 spawn() 的蛇由 record() 记为整条重发
+        for (int i = 0; i < config.snakes; ++i) {
+            if (!arena.isAlive(i) && rng.bounded(3) == 0) arena.spawn(i);
+            actions[i] = arena.isAlive(i) && rng.bounded(3) != 0 ? arena.direction(i)
+                                                                 : static_cast<Direction>(rng.bounded(4));
+        }
+        arena.step(actions.data(), results.data());
+        history.record(arena, results.data());
+
+        for (int c = 0; c < CLIENT_COUNT; ++c) {
+            Client& client = clients[c];
+            int loss = LOSS_PERCENT[c];
+            history.encode(arena, client.ack, packet);
+            if (static_cast<int>(rng.bounded(100)) >= loss) client.inFlight.push_back(packet);
+            // 前两个客户端按顺序收包，其余的乱序
+            while (!client.inFlight.empty() && (c == 0 || rng.bounded(4) != 0)) {
+                size_t k = c < 2 ? 0 : rng.bounded(static_cast<uint32_t>(client.inFlight.size()));
+                std::vector<uint8_t> received = client.inFlight[k];
+                client.inFlight.erase(client.inFlight.begin() + k);
+                client.mirror.apply(received.data(), static_cast<int>(received.size()));
+                if (static_cast<int>(rng.bounded(100)) >= loss) client.ack = client.mirror.tick();
+            }
+            // 偶尔像刚重连一样从 -1 确认起，或整批丢掉在途的包
+            if (c == CLIENT_COUNT - 1 && t % 500 == 0) client.ack = -1;
+            if (client.inFlight.size() > MAX_IN_FLIGHT) client.inFlight.clear();
+
+            if (client.mirror.tick() == arena.ticks()) {
+                ++checks;
+                if (!sameState(arena, client.mirror)) {
+                    std::cerr << config.cols << "x" << config.rows << " client " << c << " tick " << t
+                              << ": mirror differs from the arena" << std::endl;
+                    return false;
+                }
+            } else if (c == 0) {
+                std::cerr << config.cols << "x" << config.rows << " tick " << t
+                          << ": lossless client fell behind at tick " << client.mirror.tick() << std::endl;
+                return false;
+            }
+        }
+    }
+    std::cout << config.cols << "x" << config.rows << " x" << config.snakes << ": " << steps << " steps in sync"
+              << std::endl;
+    return true;
+}
+
+// 构造坏包用：与协议相同的低位在前的位流
+class PacketWriter {
+public:
+    explicit PacketWriter(std::vector<uint8_t>& out) : out(out), acc(0), bits(0) {}
+
+    void put(uint32_t value, int count) {
+        acc |= static_cast<uint64_t>(value) << bits;
+        bits += count;
+        while (bits >= 8) {
+            out.push_back(static_cast<uint8_t>(acc));
+            acc >>= 8;
+            bits -= 8;
+        }
+    }
+    void putVarint(uint32_t value) {
+        while (value >= 8) {
+            put((value & 7) | 8, 4);
+            value >>= 3;
+        }
+        put(value, 4);
+    }
+    void flush() {
+        if (bits > 0) out.push_back(static_cast<uint8_t>(acc));
+        acc = 0;
+        bits = 0;
+    }
+
+private:
+    std::vector<uint8_t>& out;
+    uint64_t acc;
+    int bits;
+};
+
+// 与 NetProtocol.cpp 中的编号一致
+const uint32_t DELTA_RUN = 2;
+const uint32_t DELTA_RESET = 3;
+
+enum BadPacket {
+    GOOD_RUN,           // 对照：合法的一步
+    BAD_TYPE,           // 包类型不对
+    BAD_SNAKE_COUNT,    // 蛇的条数与客户端不符
+    BAD_BASE,           // 基准不是客户端当前的 tick
+    BAD_RETRACT_WRAP,   // 收回 0xffffffff 节：加 2 后回绕
+    BAD_RETRACT_ALL,    // 收回之后不到两节
+    BAD_VARINT_33_BITS, // 2^32 + 1：第 33 位会被悄悄丢掉
+    BAD_VARINT_LONG,    // 12 组的变长整数
+    BAD_HEAD_OUTSIDE,   // 新蛇头走出棋盘
+    BAD_HEADS_COUNT,    // 新蛇头的个数超过格子数
+    BAD_RESET_LENGTH,   // 重新放置的蛇只有一节
+    BAD_FOOD_GAP,       // 食物的间隔超出棋盘
+    BAD_FOOD_MISSING,   // 吃掉一个不存在的食物
+    BAD_PACKET_COUNT
+};
+
+const char* const BAD_PACKET_NAMES[] = {
+    "good run", "type", "snake count", "base", "retract wrap", "retract all", "varint 33 bits",
+    "varint long", "head outside", "heads count", "reset length", "food gap", "food missing",
+};
+
+// 单条蛇的棋盘上先应用一个完整快照，再应用按 kind 构造的增量包，返回 apply() 的结果
+bool applyCrafted(BadPacket kind) {
+    const int cols = 12;
+    const int rows = 10;
+    Arena arena(cols, rows, 1, 6, 11);
+    SnapshotHistory history;
+    history.start(arena);
+    NetMirror mirror;
+    mirror.setup(cols, rows, 1);
+    std::vector<uint8_t> packet;
+    history.encode(arena, -1, packet);
+    if (!mirror.apply(packet.data(), static_cast<int>(packet.size()))) return false;
+
+    // 找一个走出去仍在棋盘内、不是掉头的方向
+    Position head = mirror.head(0);
+    Direction inward = mirror.direction(0);
+    for (int d = 0; d < 4; ++d) {
+        Position p = advance(head, static_cast<Direction>(d));
+        bool inside = p.x >= 0 && p.x < cols && p.y >= 0 && p.y < rows;
+        if (inside && static_cast<Direction>(d) != opposite(mirror.direction(0))) inward = static_cast<Direction>(d);
+    }
+    int emptyCell = 0;
+    while (mirror.hasFood({emptyCell % cols, emptyCell / cols})) ++emptyCell;
+
+    uint32_t tick = static_cast<uint32_t>(mirror.tick()) + 1;
+    uint32_t base = kind == BAD_BASE ? tick + 5 : static_cast<uint32_t>(mirror.tick());
+    std::vector<uint8_t> crafted(11, 0);
+    crafted[0] = kind == BAD_TYPE ? PACKET_INPUT : PACKET_SNAPSHOT;
+    for (int k = 0; k < 4; ++k) {
+        crafted[1 + k] = static_cast<uint8_t>(tick >> (8 * k));
+        crafted[5 + k] = static_cast<uint8_t>(base >> (8 * k));
+    }
+    crafted[9] = kind == BAD_SNAKE_COUNT ? 2 : 1;
+    PacketWriter writer(crafted);
+
+    if (kind == BAD_RESET_LENGTH) {
+        writer.put(DELTA_RESET, 2);
+        writer.put(1, 1);
+        writer.putVarint(1);
+        writer.putVarint(0);
+    } else if (kind == BAD_HEAD_OUTSIDE) {
+        // 一直往左走，第 head.x + 1 个新蛇头出界
+        writer.put(DELTA_RUN, 2);
+        writer.putVarint(static_cast<uint32_t>(head.x + 1));
+        for (int k = 0; k <= head.x; ++k) writer.put(LEFT, 2);
+        writer.putVarint(0);
+    } else {
+        writer.put(DELTA_RUN, 2);
+        writer.putVarint(kind == BAD_HEADS_COUNT ? cols * rows + 1 : 1);
+        int heads = kind == BAD_HEADS_COUNT ? cols * rows + 1 : 1;
+        for (int k = 0; k < heads; ++k) writer.put(inward, 2);
+        if (kind == BAD_RETRACT_WRAP) {
+            writer.putVarint(0xffffffffu);
+        } else if (kind == BAD_RETRACT_ALL) {
+            writer.putVarint(static_cast<uint32_t>(mirror.length(0)));
+        } else if (kind == BAD_VARINT_33_BITS) {
+            // 最低组为 1，中间九组为 0，第 11 组的第三位（第 33 位）置 1
+            writer.put(1 | 8, 4);
+            for (int k = 0; k < 9; ++k) writer.put(8, 4);
+            writer.put(4, 4);
+        } else if (kind == BAD_VARINT_LONG) {
+            for (int k = 0; k < 12; ++k) writer.put(8, 4);
+            writer.put(0, 4);
+        } else {
+            writer.putVarint(1);
+        }
+    }
+    // 食物：先是吃掉的，再是放下的
+    if (kind == BAD_FOOD_MISSING) {
+        writer.putVarint(1);
+        writer.putVarint(static_cast<uint32_t>(emptyCell));
+    } else {
+        writer.putVarint(0);
+    }
+    if (kind == BAD_FOOD_GAP) {
+        writer.putVarint(1);
+        writer.putVarint(static_cast<uint32_t>(cols * rows));
+    } else {
+        writer.putVarint(0);
+    }
+    writer.flush();
+    return mirror.apply(crafted.data(), static_cast<int>(crafted.size()));
+}
+
+bool runCorrupt(long long& rejected) {
+    bool ok = true;
+    // 加入回复里的棋盘尺寸：客户端直接拿来 setup()，须是单机也能开的大小
+    const WelcomePacket WELCOMES[] = {
+        {0, MIN_BOARD_COLS, MIN_BOARD_ROWS, 1}, {0, MIN_BOARD_COLS - 1, 10, 1}, {0, 10, 0, 1},
+        {0, MAX_BOARD_SIDE + 1, 10, 1},         {3, 10, 10, 3},
+    };
+    for (size_t k = 0; k < sizeof(WELCOMES) / sizeof(WELCOMES[0]); ++k) {
+        uint8_t bytes[16];
+        WelcomePacket welcome;
+        bool accepted = readWelcome(bytes, writeWelcome(WELCOMES[k], bytes), welcome);
+        if (accepted != (k == 0)) {
+            std::cerr << "welcome " << WELCOMES[k].cols << "x" << WELCOMES[k].rows << " for snake "
+                      << WELCOMES[k].snake << ": readWelcome() returned " << accepted << std::endl;
+            ok = false;
+        }
+        rejected += !accepted;
+    }
+
+    for (int kind = 0; kind < BAD_PACKET_COUNT; ++kind) {
+        bool applied = applyCrafted(static_cast<BadPacket>(kind));
+        if (applied != (kind == GOOD_RUN)) {
+            std::cerr << "crafted packet \"" << BAD_PACKET_NAMES[kind] << "\": apply() returned " << applied
+                      << std::endl;
+            ok = false;
+        }
+        rejected += !applied;
+    }
+
+    Arena arena(24, 18, 12, 20, 21);
+    SnapshotHistory history;
+    history.start(arena);
+    Rng rng(77);
+    std::vector<Direction> actions(arena.snakeCount());
+    std::vector<StepResult> results(arena.snakeCount());
+    std::vector<uint8_t> full;
+    std::vector<uint8_t> delta;
+    std::vector<uint8_t> damaged;
+    NetMirror mirror;
+    mirror.setup(arena.cols(), arena.rows(), arena.snakeCount());
+
+    for (int t = 0; t < 200 && ok; ++t) {
+        long long base = arena.ticks();
+        history.encode(arena, -1, full);
+        for (int i = 0; i < arena.snakeCount(); ++i) {
+            if (!arena.isAlive(i)) arena.spawn(i);
+            actions[i] = rng.bounded(4) == 0 ? static_cast<Direction>(rng.bounded(4)) : arena.direction(i);
+        }
+        arena.step(actions.data(), results.data());
+        history.record(arena, results.data());
+        history.encode(arena, base, delta);
+
+        // 截断：解码总会读到缺掉的位，客户端清空局面
+        for (const std::vector<uint8_t>* source : {&full, &delta}) {
+            for (size_t size = 0; size < source->size(); ++size) {
+                mirror.setup(arena.cols(), arena.rows(), arena.snakeCount());
+                if (source == &delta && !mirror.apply(full.data(), static_cast<int>(full.size()))) {
+                    std::cerr << "tick " << t << ": full snapshot rejected" << std::endl;
+                    return false;
+                }
+                if (mirror.apply(source->data(), static_cast<int>(size))) {
+                    std::cerr << "tick " << t << ": " << (source == &full ? "full" : "delta") << " packet cut to "
+                              << size << " of " << source->size() << " bytes was accepted" << std::endl;
+                    ok = false;
+                }
+                ++rejected;
+            }
+        }
+
+        // 随机翻转：结果可能碰巧合法，只要求不崩溃，且下一个完整快照能恢复一致
+        for (int k = 0; k < 50; ++k) {
+            mirror.setup(arena.cols(), arena.rows(), arena.snakeCount());
+            mirror.apply(full.data(), static_cast<int>(full.size()));
+            damaged = rng.bounded(2) == 0 ? full : delta;
+            for (int flips = 1 + rng.bounded(3); flips > 0; --flips) {
+                uint32_t bit = rng.bounded(static_cast<uint32_t>(damaged.size() * 8));
+                damaged[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+            }
+            mirror.apply(damaged.data(), static_cast<int>(damaged.size()));
+            std::vector<uint8_t> resync;
+            history.encode(arena, -1, resync);
+            // 翻转的 tick 可能比现在还新，这时完整快照会被当作过时的包
+            if (mirror.tick() >= arena.ticks()) continue;
+            if (!mirror.apply(resync.data(), static_cast<int>(resync.size())) || !sameState(arena, mirror)) {
+                std::cerr << "tick " << t << ": full snapshot did not recover after a corrupt packet" << std::endl;
+                return false;
+            }
+        }
+    }
+    return ok;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    long long steps = 4000;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            steps = std::atoll(argv[++i]);
+        } else {
+            std::cerr << "Usage: NetMirrorSync [--steps N]" << std::endl;
+            return 2;
+        }
+    }
+    bool ok = true;
+    long long checks = 0;
+    for (const SyncConfig& config : SYNC_CONFIGS) {
+        ok = runSync(config, steps, checks) && ok;
+    }
+    std::cout << checks << " mirror states checked" << std::endl;
+    long long rejected = 0;
+    if (runCorrupt(rejected)) {
+        std::cout << rejected << " bad packets rejected" << std::endl;
+    } else {
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
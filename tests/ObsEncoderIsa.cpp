@@ -0,0 +1,225 @@
+// ObsEncoder 的对比测试：CPU 支持的每种指令集（标量、SSE2、AVX2）在三种格式、多种截取半径、带或不带年龄平面下，
+// 编码结果都必须与逐格计算的参考结果逐字节相同；棋盘包括宽于 64 格、只有一行等情况，
+// SnakeEngine 与 VecEngine（含自动重开）两个入口都测
+// 用法：ObsEncoderIsa [--steps N]；有不一致时打印第一处并返回 1
+#include "ObsEncoder.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct ObsBoard {
+    int cols;
+    int rows;
+};
+
+const ObsBoard OBS_BOARDS[] = {
+    {4, 1},
+    {70, 1},
+    {130, 3},
+    {65, 9},
+    {16, 16},
+    {100, 70},
+};
+
+// 0 为整个棋盘；MAX_CROP_RADIUS + 5 应按 MAX_CROP_RADIUS 处理
+const int CROP_RADII[] = {0, 1, 2, 7, 16, ObsEncoder::MAX_CROP_RADIUS, ObsEncoder::MAX_CROP_RADIUS + 5};
+
+const ObsFormat OBS_FORMATS[] = {OBS_BITS, OBS_U8, OBS_F32};
+const char* const OBS_FORMAT_NAMES[] = {"bits", "u8", "f32"};
+
+// 一个棋盘的局面：蛇身从蛇头到蛇尾；segments 为每格是从蛇头数起的第几节，没有蛇身为 -1
+struct BoardState {
+    int cols;
+    int rows;
+    std::vector<Position> body;
+    std::vector<int> segments;
+    Position food;
+
+    void addSegment(Position cell) {
+        segments[cell.y * cols + cell.x] = static_cast<int>(body.size());
+        body.push_back(cell);
+    }
+};
+
+BoardState stateOf(const SnakeEngine& engine) {
+    BoardState state = {engine.cols(), engine.rows(), {}, std::vector<int>(engine.cols() * engine.rows(), -1),
+                        engine.food()};
+    for (int k = 0; k < engine.body().size(); ++k) state.addSegment(engine.body()[k]);
+    return state;
+}
+
+BoardState stateOf(const VecEngine& envs, int i) {
+    BoardState state = {envs.cols(), envs.rows(), {}, std::vector<int>(envs.cols() * envs.rows(), -1),
+                        envs.food(i)};
+    for (int k = 0; k < envs.length(i); ++k) state.addSegment(envs.segment(i, k));
+    return state;
+}
+
+void setValue(ObsFormat format, unsigned char* plane, int index, float value) {
+    switch (format) {
+        case OBS_BITS:
+            if (value != 0) reinterpret_cast<uint64_t*>(plane)[index >> 6] |= uint64_t(1) << (index & 63);
+            break;
+        case OBS_U8: plane[index] = static_cast<unsigned char>(value); break;
+        default: reinterpret_cast<float*>(plane)[index] = value; break;
+    }
+}
+
+// 逐格计算：输出的每一格对应棋盘上的哪一格，在不在棋盘内、是不是蛇身/蛇头/食物
+void referenceEncode(const BoardState& state, ObsFormat format, int radius, bool withAge, const ObsEncoder& encoder,
+                     std::vector<uint64_t>& out) {
+    out.assign((encoder.bytesPerBoard() + 7) / 8, 0);
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(out.data());
+    const size_t planeBytes = encoder.bytesPerBoard() / encoder.planes();
+    const int width = encoder.width();
+    const int height = encoder.height();
+    const Position head = state.body[0];
+    const int length = static_cast<int>(state.body.size());
+    for (int cy = 0; cy < height; ++cy) {
+        for (int cx = 0; cx < width; ++cx) {
+            Position cell = radius > 0 ? Position{head.x - radius + cx, head.y - radius + cy} : Position{cx, cy};
+            int index = cy * width + cx;
+            bool inside = cell.x >= 0 && cell.x < state.cols && cell.y >= 0 && cell.y < state.rows;
+            if (!inside) {
+                setValue(format, bytes + OBS_WALL * planeBytes, index, 1);
+                continue;
+            }
+            int k = state.segments[cell.y * state.cols + cell.x];
+            if (k >= 0) {
+                setValue(format, bytes + OBS_BODY * planeBytes, index, 1);
+                if (withAge && format != OBS_BITS) {
+                    int remaining = length - k;
+                    float age = format == OBS_U8 ? static_cast<float>(remaining < 255 ? remaining : 255)
+                                                 : static_cast<float>(remaining) / length;
+                    setValue(format, bytes + OBS_AGE * planeBytes, index, age);
+                }
+            }
+            if (cell == head) setValue(format, bytes + OBS_HEAD * planeBytes, index, 1);
+            if (cell == state.food) setValue(format, bytes + OBS_FOOD * planeBytes, index, 1);
+        }
+    }
+}
+
+struct EncoderCase {
+    ObsFormat format;
+    int radius;
+    bool withAge;
+};
+
+std::string describe(const BoardState& state, const EncoderCase& c, ObsIsa isa) {
+    return std::to_string(state.cols) + "x" + std::to_string(state.rows) + " " + OBS_FORMAT_NAMES[c.format] +
+           " r" + std::to_string(c.radius) + (c.withAge ? " age" : "") + " " + ObsEncoder::isaName(isa);
+}
+
+bool compare(const BoardState& state, const EncoderCase& c, ObsIsa isa, const ObsEncoder& encoder,
+             const std::vector<uint64_t>& expected, const unsigned char* actual, long long tick) {
+    const unsigned char* want = reinterpret_cast<const unsigned char*>(expected.data());
+    if (std::memcmp(want, actual, encoder.bytesPerBoard()) != 0) {
+        size_t k = 0;
+        while (want[k] == actual[k]) ++k;
+        std::cerr << describe(state, c, isa) << " tick " << tick << ": byte " << k << " of "
+                  << encoder.bytesPerBoard() << " differs" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 大多直走，偶尔随机转向，蛇会撞死后重开，也会在小棋盘上吃满
+Direction randomAction(Direction current, Rng& rng) {
+    return rng.bounded(5) == 0 ? static_cast<Direction>(rng.bounded(4)) : current;
+}
+
+bool runBoard(const ObsBoard& board, long long steps, std::vector<ObsIsa>& isas, long long& checks) {
+    std::vector<EncoderCase> cases;
+    for (ObsFormat format : OBS_FORMATS) {
+        for (int radius : CROP_RADII) {
+            cases.push_back({format, radius, false});
+            if (format != OBS_BITS) cases.push_back({format, radius, true});
+        }
+    }
+    std::vector<ObsEncoder> encoders;
+    for (const EncoderCase& c : cases) encoders.emplace_back(board.cols, board.rows, c.format, c.radius, c.withAge);
+
+    const int envCount = 3;
+    SnakeEngine engine(board.cols, board.rows, 1);
+    VecEngine envs(envCount, board.cols, board.rows, 2);
+    Rng rng(static_cast<uint32_t>(board.cols * 1000 + board.rows));
+    std::vector<Direction> actions(envCount);
+    std::vector<StepResult> results(envCount);
+    std::vector<uint64_t> out;
+    // 第 0 个为 engine，其后为 envs 的各个棋盘
+    std::vector<std::vector<uint64_t>> expected(1 + envCount);
+    unsigned int resets = 0;
+
+    for (long long t = 0; t < steps; ++t) {
+        if (engine.isOver()) engine.reset(++resets + 100);
+        engine.step(randomAction(engine.direction(), rng));
+        for (int i = 0; i < envCount; ++i) actions[i] = randomAction(envs.direction(i), rng);
+        envs.step(actions.data(), results.data());
+        BoardState single = stateOf(engine);
+        std::vector<BoardState> batch;
+        for (int i = 0; i < envCount; ++i) batch.push_back(stateOf(envs, i));
+
+        for (size_t n = 0; n < cases.size(); ++n) {
+            ObsEncoder& encoder = encoders[n];
+            const EncoderCase& c = cases[n];
+            int radius = c.radius > ObsEncoder::MAX_CROP_RADIUS ? ObsEncoder::MAX_CROP_RADIUS : c.radius;
+            referenceEncode(single, c.format, radius, c.withAge, encoder, expected[0]);
+            for (int i = 0; i < envCount; ++i) {
+                referenceEncode(batch[i], c.format, radius, c.withAge, encoder, expected[i + 1]);
+            }
+            for (ObsIsa isa : isas) {
+                encoder.useIsa(isa);
+                out.assign((encoder.bytesPerBoard() * envCount + 7) / 8, 0);
+                unsigned char* bytes = reinterpret_cast<unsigned char*>(out.data());
+                // 先填满非零，确认编码会写满每一个字节
+                std::memset(bytes, 0xa5, encoder.bytesPerBoard() * envCount);
+                encoder.encode(engine, bytes);
+                if (!compare(single, c, isa, encoder, expected[0], bytes, t)) return false;
+                std::memset(bytes, 0xa5, encoder.bytesPerBoard() * envCount);
+                encoder.encode(envs, bytes);
+                for (int i = 0; i < envCount; ++i) {
+                    if (!compare(batch[i], c, isa, encoder, expected[i + 1], bytes + i * encoder.bytesPerBoard(), t)) {
+                        return false;
+                    }
+                }
+                checks += 1 + envCount;
+            }
+        }
+    }
+    std::cout << board.cols << "x" << board.rows << ": " << steps << " steps, " << cases.size()
+              << " encoder settings match the reference" << std::endl;
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    long long steps = 200;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            steps = std::atoll(argv[++i]);
+        } else {
+            std::cerr << "Usage: ObsEncoderIsa [--steps N]" << std::endl;
+            return 2;
+        }
+    }
+    // CPU 不支持的指令集 useIsa() 会退回 bestIsa()，只测支持的
+    std::vector<ObsIsa> isas;
+    for (int isa = OBS_ISA_SCALAR; isa <= ObsEncoder::bestIsa(); ++isa) isas.push_back(static_cast<ObsIsa>(isa));
+    std::cout << "Instruction sets:";
+    for (ObsIsa isa : isas) std::cout << " " << ObsEncoder::isaName(isa);
+    std::cout << std::endl;
+
+    bool ok = true;
+    long long checks = 0;
+    for (const ObsBoard& board : OBS_BOARDS) {
+        ok = runBoard(board, steps, isas, checks) && ok;
+    }
+    std::cout << checks << " observations checked" << std::endl;
+    return ok ? 0 : 1;
+}
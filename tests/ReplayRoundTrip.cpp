@@ -0,0 +1,224 @@
+// 录像的往返测试：随机对局照 main.cpp 的方式录下转向，save() 后 load()，回放必须逐位复现终局（stateHash）；
+// 截断、多出字节、文件头或终局哈希的位翻转以及棋盘尺寸不合法的文件都必须被拒绝（decode() 失败或回放对不上终局）
+// 用法：ReplayRoundTrip [--games N]；有问题时打印第一处并返回 1
+#include "Replay.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct RoundTripConfig {
+    int cols;
+    int rows;
+    // 最多走的步数；为 0 时一直走到撞死或吃满
+    long long maxTicks;
+};
+
+const RoundTripConfig ROUND_TRIP_CONFIGS[] = {
+    {4, 1, 0},
+    {6, 4, 0},
+    {20, 15, 0},
+    {20, 15, 60},
+    {64, 48, 150},
+};
+
+const char* const REPLAY_TEST_FILE = "ReplayRoundTrip.snkr";
+
+bool blocked(const SnakeEngine& engine, Position p) {
+    return p.x < 0 || p.y < 0 || p.x >= engine.cols() || p.y >= engine.rows() || engine.segmentAt(p) >= 0;
+}
+
+// 大多直走，前方被挡时尽量拐开；偶尔完全随机（包括掉头，应被忽略）
+Direction chooseAction(const SnakeEngine& engine, Rng& rng) {
+    Direction d = engine.direction();
+    if (rng.bounded(40) == 0) {
+        return static_cast<Direction>(rng.bounded(4));
+    }
+    if (rng.bounded(6) == 0 || blocked(engine, advance(engine.body()[0], d))) {
+        for (int tries = 0; tries < 4; ++tries) {
+            Direction turn = static_cast<Direction>(rng.bounded(4));
+            if (turn != opposite(d) && !blocked(engine, advance(engine.body()[0], turn))) return turn;
+        }
+    }
+    return d;
+}
+
+// 转向照 main.cpp 记为这一步实际采用的方向
+Replay recordGame(const RoundTripConfig& config, unsigned int seed, Rng& rng) {
+    SnakeEngine engine(config.cols, config.rows, seed);
+    Replay replay;
+    replay.begin(config.cols, config.rows, seed);
+    while (!engine.isOver() && (config.maxTicks == 0 || engine.ticks() < config.maxTicks)) {
+        Direction action = chooseAction(engine, rng);
+        Direction oldDir = engine.direction();
+        long long tick = engine.ticks();
+        engine.step(action);
+        if (engine.direction() != oldDir) {
+            replay.recordTurn(tick, engine.direction());
+        }
+    }
+    replay.finish(engine.ticks(), engine.stateHash());
+    return replay;
+}
+
+// 能解码且回放的终局与文件里的哈希一致
+bool playsBack(const std::vector<uint8_t>& bytes) {
+    Replay replay;
+    if (!replay.decode(bytes.data(), bytes.size())) {
+        return false;
+    }
+    SnakeEngine engine(replay.cols(), replay.rows(), replay.seed());
+    ReplayPlayer player(replay);
+    player.start(engine);
+    player.runToEnd(engine);
+    return player.matches(engine) && engine.ticks() == replay.ticks();
+}
+
+bool checkGame(const RoundTripConfig& config, unsigned int seed, Rng& rng, long long& rejected, int& flipped,
+               long long& equivalent) {
+    Replay recorded = recordGame(config, seed, rng);
+    std::string label = std::to_string(config.cols) + "x" + std::to_string(config.rows) + " seed " +
+                        std::to_string(seed);
+    if (!recorded.save(REPLAY_TEST_FILE)) {
+        std::cerr << label << ": unable to write " << REPLAY_TEST_FILE << std::endl;
+        return false;
+    }
+    Replay loaded;
+    if (!loaded.load(REPLAY_TEST_FILE)) {
+        std::cerr << label << ": saved replay did not load" << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> bytes = recorded.encode();
+    if (loaded.encode() != bytes || loaded.turnCount() != recorded.turnCount()) {
+        std::cerr << label << ": loaded replay differs from the recording" << std::endl;
+        return false;
+    }
+    SnakeEngine engine(loaded.cols(), loaded.rows(), loaded.seed());
+    ReplayPlayer player(loaded);
+    player.start(engine);
+    player.runToEnd(engine);
+    if (!player.matches(engine) || engine.ticks() != recorded.ticks()) {
+        std::cerr << label << ": playback ended at tick " << engine.ticks() << " with a different state"
+                  << std::endl;
+        return false;
+    }
+
+    for (size_t size = 0; size < bytes.size(); ++size) {
+        if (loaded.decode(bytes.data(), size)) {
+            std::cerr << label << ": replay cut to " << size << " of " << bytes.size() << " bytes was accepted"
+                      << std::endl;
+            return false;
+        }
+        ++rejected;
+    }
+    std::vector<uint8_t> longer = bytes;
+    longer.push_back(0);
+    if (loaded.decode(longer.data(), longer.size())) {
+        std::cerr << label << ": replay with a trailing byte was accepted" << std::endl;
+        return false;
+    }
+    ++rejected;
+
+    // 撞死的对局改大总步数仍会停在同一处，只对中途停下的对局逐位翻转。
+    // 文件头（尺寸、种子、总步数）、方向字节末尾没用上的位与终局哈希损坏必须被发现；转向数据损坏后可能碰巧走出完全相同的终局
+    // （某次转向提前一步，后面的直路正好补回来），这样的录像与原录像等价，只计数
+    if (config.maxTicks > 0 && recorded.ticks() == config.maxTicks) {
+        ++flipped;
+        Replay header;
+        header.begin(recorded.cols(), recorded.rows(), recorded.seed());
+        header.finish(recorded.ticks(), recorded.finalHash());
+        // 去掉终局哈希与转向次数（不到 128 次时占一个字节）
+        size_t headerBits = (header.encode().size() - 8 - 1) * 8;
+        size_t hashBits = (bytes.size() - 8) * 8;
+        // 最后一个方向字节里没用上的位
+        size_t paddingBits = recorded.turnCount() % 4 != 0 ? hashBits - 8 + recorded.turnCount() % 4 * 2 : hashBits;
+        for (size_t bit = 0; bit < bytes.size() * 8; ++bit) {
+            std::vector<uint8_t> damaged = bytes;
+            damaged[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+            if (!playsBack(damaged)) {
+                ++rejected;
+            } else if (bit < headerBits || bit >= paddingBits || recorded.turnCount() >= 128) {
+                std::cerr << label << ": replay with bit " << bit << " flipped still plays back" << std::endl;
+                return false;
+            } else {
+                ++equivalent;
+            }
+        }
+    }
+    return true;
+}
+
+// 棋盘尺寸超出 validBoardSize() 的录像：规则引擎按这个尺寸开局会越界或溢出
+bool checkBadSizes(long long& rejected) {
+    const int BAD_SIZES[][2] = {
+        {0, 0}, {1, 1}, {3, 5}, {MIN_BOARD_COLS, 0}, {MAX_BOARD_SIDE + 1, 10}, {10, MAX_BOARD_SIDE + 1},
+        {65536, 65536},
+    };
+    for (const auto& size : BAD_SIZES) {
+        Replay bad;
+        bad.begin(size[0], size[1], 1);
+        bad.finish(10, 0);
+        std::vector<uint8_t> bytes = bad.encode();
+        Replay decoded;
+        if (decoded.decode(bytes.data(), bytes.size())) {
+            std::cerr << "replay with a " << size[0] << "x" << size[1] << " board was accepted" << std::endl;
+            return false;
+        }
+        ++rejected;
+    }
+    // 魔数或版本不对
+    Replay good;
+    good.begin(MIN_BOARD_COLS, MIN_BOARD_ROWS, 1);
+    good.finish(1, 0);
+    for (size_t k = 0; k <= sizeof(REPLAY_MAGIC); ++k) {
+        std::vector<uint8_t> bytes = good.encode();
+        bytes[k] ^= 0x40;
+        Replay decoded;
+        if (decoded.decode(bytes.data(), bytes.size())) {
+            std::cerr << "replay with header byte " << k << " changed was accepted" << std::endl;
+            return false;
+        }
+        ++rejected;
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int games = 20;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            games = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Usage: ReplayRoundTrip [--games N]" << std::endl;
+            return 2;
+        }
+    }
+    bool ok = true;
+    long long rejected = 0;
+    long long equivalent = 0;
+    Rng rng(12345);
+    for (const RoundTripConfig& config : ROUND_TRIP_CONFIGS) {
+        bool configOk = true;
+        int flipped = 0;
+        for (int g = 0; g < games && configOk; ++g) {
+            configOk = checkGame(config, 1000u + static_cast<unsigned int>(g), rng, rejected, flipped, equivalent);
+        }
+        if (configOk) {
+            std::cout << config.cols << "x" << config.rows << ": " << games
+                      << " games saved, loaded and replayed bit for bit, " << flipped << " checked bit by bit"
+                      << std::endl;
+        }
+        ok = configOk && ok;
+    }
+    ok = checkBadSizes(rejected) && ok;
+    std::remove(REPLAY_TEST_FILE);
+    std::cout << rejected << " damaged replays rejected, " << equivalent
+              << " with a flipped turn bit still reach the same final state" << std::endl;
+    return ok ? 0 : 1;
+}
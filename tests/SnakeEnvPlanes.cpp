@@ -0,0 +1,139 @@
+// 训练环境 C 接口的观测测试：snake_env_step() 只增量改动几个格子，这里用同样的种子和动作推进一个 VecEngine，
+// 每步按 writeBoard() 的方式整体重建三个平面，要求观测、奖励、结束标志逐字节相同（含自动重开与中途 reset()）
+// 用法：SnakeEnvPlanes [--steps N]；有不一致时打印第一处并返回 1
+#include "VecEngine.h"
+#include "snake_env.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+struct PlanesConfig {
+    int count;
+    int cols;
+    int rows;
+    uint32_t seed;
+};
+
+// 小棋盘会很快撞死或吃满，覆盖自动重开和 STEP_WON
+const PlanesConfig PLANES_CONFIGS[] = {
+    {8, 4, 1, 1},
+    {16, 6, 3, 2},
+    {16, 5, 5, 3},
+    {8, 16, 12, 4},
+    {4, 70, 9, 5},
+};
+
+// 按 SNAKE_ENV_ALIGNMENT 对齐的缓冲区
+template <class T>
+struct AlignedBuffer {
+    explicit AlignedBuffer(size_t count) : storage(count * sizeof(T) + SNAKE_ENV_ALIGNMENT) {}
+    T* data() {
+        uintptr_t p = reinterpret_cast<uintptr_t>(storage.data());
+        p = (p + SNAKE_ENV_ALIGNMENT - 1) / SNAKE_ENV_ALIGNMENT * SNAKE_ENV_ALIGNMENT;
+        return reinterpret_cast<T*>(p);
+    }
+    std::vector<uint8_t> storage;
+};
+
+// 与 snake_env.cpp 的 writeBoard() 相同：按局面整体重建第 i 个棋盘的三个平面
+void rebuildBoard(const VecEngine& engine, int i, uint8_t* obs) {
+    const size_t planeBytes = static_cast<size_t>(engine.cols()) * engine.rows();
+    std::memset(obs, 0, SNAKE_ENV_PLANES * planeBytes);
+    for (int k = 0; k < engine.length(i); ++k) {
+        Position p = engine.segment(i, k);
+        obs[p.y * engine.cols() + p.x] = 1;
+    }
+    Position head = engine.head(i);
+    Position food = engine.food(i);
+    obs[planeBytes + head.y * engine.cols() + head.x] = 1;
+    obs[2 * planeBytes + food.y * engine.cols() + food.x] = 1;
+}
+
+bool runConfig(const PlanesConfig& config, long long steps) {
+    const size_t boardBytes = snake_env_observation_bytes(config.cols, config.rows);
+    AlignedBuffer<uint8_t> observations(boardBytes * config.count);
+    AlignedBuffer<float> rewards(config.count);
+    AlignedBuffer<uint8_t> dones(config.count);
+    SnakeEnvConfig envConfig = {sizeof(SnakeEnvConfig), config.count, config.cols, config.rows,
+                                observations.data(), rewards.data(), dones.data()};
+    SnakeEnv* env = snake_env_create(&envConfig);
+    if (env == nullptr) {
+        std::cerr << config.cols << "x" << config.rows << ": snake_env_create failed" << std::endl;
+        return false;
+    }
+
+    VecEngine engine(config.count, config.cols, config.rows, config.seed);
+    snake_env_reset(env, config.seed);
+    std::vector<uint8_t> expected(boardBytes);
+    std::vector<int32_t> actions(config.count);
+    std::vector<Direction> directions(config.count);
+    std::vector<StepResult> results(config.count);
+    Rng rng(config.seed * 7919u);
+    long long ended = 0;
+    bool ok = true;
+
+    for (long long t = 0; t < steps && ok; ++t) {
+        // 中途换种子重开一次，重开后的观测同样须与整体重建一致
+        if (t == steps / 2) {
+            snake_env_reset(env, config.seed + 1000);
+            engine.reset(config.seed + 1000);
+            std::fill(results.begin(), results.end(), STEP_MOVED);
+        } else {
+            for (int i = 0; i < config.count; ++i) {
+                // 大多沿原方向走，偶尔随机转向；也夹杂超出范围的动作，应按保持原方向处理
+                uint32_t roll = rng.bounded(16);
+                actions[i] = roll == 0 ? -1 : (roll < 4 ? static_cast<int32_t>(rng.bounded(4)) : engine.direction(i));
+                directions[i] = actions[i] >= UP && actions[i] <= RIGHT ? static_cast<Direction>(actions[i])
+                                                                        : engine.direction(i);
+            }
+            snake_env_step(env, actions.data());
+            engine.step(directions.data(), results.data());
+        }
+
+        for (int i = 0; i < config.count && ok; ++i) {
+            StepResult result = results[i];
+            bool done = result == STEP_DIED || result == STEP_WON;
+            float reward = result == STEP_ATE || result == STEP_WON ? 1.0f : (result == STEP_DIED ? -1.0f : 0.0f);
+            ended += done;
+            rebuildBoard(engine, i, expected.data());
+            if (std::memcmp(expected.data(), observations.data() + i * boardBytes, boardBytes) != 0) {
+                std::cerr << config.cols << "x" << config.rows << " board " << i << " tick " << t
+                          << ": observation differs from a full rebuild" << std::endl;
+                ok = false;
+            } else if (rewards.data()[i] != reward || dones.data()[i] != (done ? 1 : 0)) {
+                std::cerr << config.cols << "x" << config.rows << " board " << i << " tick " << t << ": reward "
+                          << rewards.data()[i] << " done " << static_cast<int>(dones.data()[i]) << ", expected "
+                          << reward << " " << done << std::endl;
+                ok = false;
+            }
+        }
+    }
+    snake_env_close(env);
+    if (ok) {
+        std::cout << config.cols << "x" << config.rows << " x" << config.count << ": " << steps << " steps, "
+                  << ended << " episodes ended, planes match a full rebuild" << std::endl;
+    }
+    return ok;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    long long steps = 20000;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            steps = std::atoll(argv[++i]);
+        } else {
+            std::cerr << "Usage: SnakeEnvPlanes [--steps N]" << std::endl;
+            return 2;
+        }
+    }
+    bool ok = true;
+    for (const PlanesConfig& config : PLANES_CONFIGS) {
+        ok = runConfig(config, steps) && ok;
+    }
+    return ok ? 0 : 1;
+}
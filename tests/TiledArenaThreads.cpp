@@ -0,0 +1,122 @@
+// TiledArena 的线程数无关性测试：同一图块大小下用不同的线程数推进同样的动作，
+// 每步比较各蛇的结果与 stateHash()；图块大小取不整除棋盘、单格邻居很多与只有一个图块等几种
+// 用法：TiledArenaThreads [--steps N]；有不一致时打印第一处并返回 1
+#include "TiledArena.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct ThreadsConfig {
+    int cols;
+    int rows;
+    int snakes;
+    int foods;
+    int tileSize;
+    unsigned int seed;
+};
+
+const ThreadsConfig THREADS_CONFIGS[] = {
+    {70, 50, 120, 200, 3, 1},
+    {70, 50, 120, 200, 16, 2},
+    {70, 50, 120, 200, 64, 3},
+    {70, 50, 120, 200, 256, 4},
+    // 蛇多、食物多，蛇身跨越很多图块，蛇头相撞也更频繁
+    {40, 40, 200, 400, 7, 5},
+};
+
+const int THREAD_COUNTS[] = {1, 2, 3, 8};
+
+bool blocked(const TiledArena& arena, Position p) {
+    return p.x < 0 || p.y < 0 || p.x >= arena.cols() || p.y >= arena.rows() || arena.ownerAt(p) >= 0;
+}
+
+// 大多直走，前方被挡时尽量拐开，让蛇活得久、长得长；偶尔完全随机（包括掉头，应被忽略）
+void chooseActions(const TiledArena& arena, Rng& rng, std::vector<Direction>& actions) {
+    for (int i = 0; i < arena.snakeCount(); ++i) {
+        if (!arena.isAlive(i)) continue;
+        Direction d = arena.direction(i);
+        if (rng.bounded(16) == 0) {
+            d = static_cast<Direction>(rng.bounded(4));
+        } else if (rng.bounded(8) == 0 || blocked(arena, advance(arena.head(i), d))) {
+            Direction turn = static_cast<Direction>(rng.bounded(4));
+            if (turn != opposite(d) && !blocked(arena, advance(arena.head(i), turn))) d = turn;
+        }
+        actions[i] = d;
+    }
+}
+
+bool runConfig(const ThreadsConfig& config, long long steps) {
+    std::vector<std::unique_ptr<TiledArena>> arenas;
+    for (int threads : THREAD_COUNTS) {
+        arenas.emplace_back(new TiledArena(config.cols, config.rows, config.snakes, config.foods, config.seed, threads,
+                                           config.tileSize));
+    }
+    const TiledArena& reference = *arenas[0];
+    Rng rng(config.seed * 7919u);
+    std::vector<Direction> actions(config.snakes, RIGHT);
+    std::vector<StepResult> expected(config.snakes);
+    std::vector<StepResult> results(config.snakes);
+    long long deaths = 0;
+
+    for (long long t = 0; t < steps; ++t) {
+        // 死去的蛇有一半的机会在这一步之前重新放置
+        for (int i = 0; i < config.snakes; ++i) {
+            if (reference.isAlive(i) || rng.bounded(2) != 0) continue;
+            bool placed = arenas[0]->spawn(i);
+            for (size_t a = 1; a < arenas.size(); ++a) {
+                if (arenas[a]->spawn(i) != placed) {
+                    std::cerr << "tile " << config.tileSize << " tick " << t << ": spawn(" << i << ") differs with "
+                              << THREAD_COUNTS[a] << " threads" << std::endl;
+                    return false;
+                }
+            }
+        }
+        chooseActions(reference, rng, actions);
+        arenas[0]->step(actions.data(), expected.data());
+        for (int i = 0; i < config.snakes; ++i) deaths += expected[i] == STEP_DIED;
+        uint64_t hash = reference.stateHash();
+        for (size_t a = 1; a < arenas.size(); ++a) {
+            arenas[a]->step(actions.data(), results.data());
+            for (int i = 0; i < config.snakes; ++i) {
+                if (results[i] != expected[i]) {
+                    std::cerr << "tile " << config.tileSize << " tick " << t << ": snake " << i << " result "
+                              << results[i] << " with " << THREAD_COUNTS[a] << " threads, expected " << expected[i]
+                              << std::endl;
+                    return false;
+                }
+            }
+            if (arenas[a]->stateHash() != hash) {
+                std::cerr << "tile " << config.tileSize << " tick " << t << ": state hash differs with "
+                          << THREAD_COUNTS[a] << " threads" << std::endl;
+                return false;
+            }
+        }
+    }
+    std::cout << config.cols << "x" << config.rows << " x" << config.snakes << " tile " << config.tileSize << " ("
+              << reference.tileCount() << " tiles): " << steps << " steps, " << deaths
+              << " deaths, same state for all thread counts" << std::endl;
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    long long steps = 1000;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            steps = std::atoll(argv[++i]);
+        } else {
+            std::cerr << "Usage: TiledArenaThreads [--steps N]" << std::endl;
+            return 2;
+        }
+    }
+    bool ok = true;
+    for (const ThreadsConfig& config : THREADS_CONFIGS) {
+        ok = runConfig(config, steps) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+// VecEngine 与 SnakeEngine 的差分测试：同样的种子和随机动作，逐步比较结果、蛇身、食物、方向与重开后的种子
+// 用法：VecEngineDiff [--steps N]；有不一致时打印第一处并返回 1
+#include "SnakeEngine.h"
+#include "VecEngine.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct DiffConfig {
+    int count;
+    int cols;
+    int rows;
+    unsigned int seed;
+};
+
+// 小棋盘会很快撞死或吃满，覆盖自动重开和 STEP_WON
+const DiffConfig DIFF_CONFIGS[] = {
+    {16, 6, 3, 1},
+    {16, 4, 2, 2},
+    {32, 5, 5, 3},
+    {16, 16, 12, 4},
+    {8, 64, 48, 5},
+};
+
+bool sameBoard(const VecEngine& vec, int i, const SnakeEngine& engine) {
+    const SnakeBody& body = engine.body();
+    if (vec.length(i) != body.size() || vec.direction(i) != engine.direction()) return false;
+    // 吃满棋盘时 SnakeEngine 不再放食物，食物位置无意义
+    if (!engine.isOver() && vec.food(i) != engine.food()) return false;
+    for (int k = 0; k < body.size(); ++k) {
+        if (vec.segment(i, k) != body[k]) return false;
+    }
+    return true;
+}
+
+bool runConfig(const DiffConfig& config, long long steps) {
+    VecEngine vec(config.count, config.cols, config.rows, config.seed);
+    std::vector<std::unique_ptr<SnakeEngine>> engines;
+    std::vector<unsigned int> episodes(config.count, 0);
+    for (int i = 0; i < config.count; ++i) {
+        engines.emplace_back(new SnakeEngine(config.cols, config.rows, config.seed + i));
+    }
+    Rng rng(config.seed * 7919u);
+    std::vector<Direction> actions(config.count);
+    std::vector<StepResult> results(config.count);
+    long long ended = 0;
+
+    for (long long t = 0; t < steps; ++t) {
+        for (int i = 0; i < config.count; ++i) {
+            // 大多沿原方向走，偶尔随机转向（包括掉头，应被忽略）
+            actions[i] = rng.bounded(4) == 0 ? static_cast<Direction>(rng.bounded(4)) : engines[i]->direction();
+        }
+        vec.step(actions.data(), results.data());
+        for (int i = 0; i < config.count; ++i) {
+            SnakeEngine& engine = *engines[i];
+            StepResult expected = engine.step(actions[i]);
+            if (results[i] != expected) {
+                std::cerr << config.cols << "x" << config.rows << " board " << i << " tick " << t << ": result "
+                          << results[i] << ", expected " << expected << std::endl;
+                return false;
+            }
+            if (expected == STEP_DIED || expected == STEP_WON) {
+                // 第 k 局的种子为 seed + i + k * count
+                ++episodes[i];
+                ++ended;
+                engine.reset(config.seed + i + episodes[i] * config.count);
+            }
+            if (vec.episodes(i) != episodes[i] || !sameBoard(vec, i, engine)) {
+                std::cerr << config.cols << "x" << config.rows << " board " << i << " tick " << t
+                          << ": state differs (episode " << vec.episodes(i) << ", expected " << episodes[i] << ")"
+                          << std::endl;
+                return false;
+            }
+        }
+    }
+    std::cout << config.cols << "x" << config.rows << " x" << config.count << ": " << steps << " steps, " << ended
+              << " episodes ended, no differences" << std::endl;
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    long long steps = 20000;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            steps = std::atoll(argv[++i]);
+        } else {
+            std::cerr << "Usage: VecEngineDiff [--steps N]" << std::endl;
+            return 2;
+        }
+    }
+    bool ok = true;
+    for (const DiffConfig& config : DIFF_CONFIGS) {
+        ok = runConfig(config, steps) && ok;
+    }
+    return ok ? 0 : 1;
+}
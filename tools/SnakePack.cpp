@@ -0,0 +1,120 @@
+// 资源打包工具：把 PNG 预先解码成 RGBA32 像素，连同尺寸信息写进一个资源包
+// 用法：SnakePack                         打包游戏的全部图片到 picture\assets.pak
+//       SnakePack out.pak name=file.png ... 打包指定图片
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "AssetBundle.h"
+#include "GameAssets.h"
+#undef main
+
+struct PackItem {
+    std::string name;
+    std::string path;
+    SDL_Surface* pixels;
+};
+
+int main(int argc, char* argv[]) {
+    std::string output = GAME_BUNDLE_PATH;
+    std::vector<PackItem> items;
+    if (argc > 1) {
+        output = argv[1];
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            size_t split = arg.find('=');
+            if (split == std::string::npos) {
+                std::cerr << "Expected name=file.png, got " << arg << std::endl;
+                return 1;
+            }
+            items.push_back({arg.substr(0, split), arg.substr(split + 1), nullptr});
+        }
+    } else {
+        for (int i = 0; i < ASSET_COUNT; ++i) {
+            items.push_back({GAME_ASSETS[i].name, GAME_ASSETS[i].path, nullptr});
+        }
+    }
+
+    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+        std::cerr << "SDL_image could not initialize! SDL_image Error: " << IMG_GetError() << std::endl;
+        return 1;
+    }
+
+    // 解码并统一转换为 RGBA32
+    bool ok = true;
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (items[i].name.size() >= static_cast<size_t>(BUNDLE_NAME_SIZE)) {
+            std::cerr << "Asset name too long: " << items[i].name << std::endl;
+            ok = false;
+            break;
+        }
+        SDL_Surface* loaded = IMG_Load(items[i].path.c_str());
+        if (loaded == nullptr) {
+            std::cerr << "Unable to load image " << items[i].path << "! SDL_image Error: " << IMG_GetError() << std::endl;
+            ok = false;
+            break;
+        }
+        items[i].pixels = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(loaded);
+        if (items[i].pixels == nullptr) {
+            std::cerr << "Unable to convert " << items[i].path << "! SDL Error: " << SDL_GetError() << std::endl;
+            ok = false;
+            break;
+        }
+    }
+
+    if (ok) {
+        // 先排好每张图的位置，再依次写出文件头、目录和像素
+        BundleHeader header;
+        std::memcpy(header.magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC));
+        header.version = BUNDLE_VERSION;
+        header.count = static_cast<uint32_t>(items.size());
+
+        std::vector<BundleEntry> entries(items.size());
+        uint64_t offset = sizeof(BundleHeader) + items.size() * sizeof(BundleEntry);
+        for (size_t i = 0; i < items.size(); ++i) {
+            SDL_Surface* surface = items[i].pixels;
+            BundleEntry& entry = entries[i];
+            std::memset(&entry, 0, sizeof(entry));
+            std::strncpy(entry.name, items[i].name.c_str(), BUNDLE_NAME_SIZE - 1);
+            entry.width = static_cast<uint32_t>(surface->w);
+            entry.height = static_cast<uint32_t>(surface->h);
+            entry.pitch = static_cast<uint32_t>(surface->w) * 4;
+            entry.format = BUNDLE_PIXEL_FORMAT;
+            offset = (offset + BUNDLE_ALIGNMENT - 1) / BUNDLE_ALIGNMENT * BUNDLE_ALIGNMENT;
+            entry.offset = offset;
+            entry.size = static_cast<uint64_t>(entry.pitch) * entry.height;
+            offset += entry.size;
+        }
+
+        std::ofstream file(output.c_str(), std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(BundleEntry));
+        uint64_t written = sizeof(BundleHeader) + entries.size() * sizeof(BundleEntry);
+        const char padding[BUNDLE_ALIGNMENT] = {};
+        for (size_t i = 0; i < items.size(); ++i) {
+            file.write(padding, static_cast<std::streamsize>(entries[i].offset - written));
+            SDL_Surface* surface = items[i].pixels;
+            for (int y = 0; y < surface->h; ++y) {
+                file.write(static_cast<const char*>(surface->pixels) + y * surface->pitch, entries[i].pitch);
+            }
+            written = entries[i].offset + entries[i].size;
+        }
+        if (!file) {
+            std::cerr << "Unable to write " << output << std::endl;
+            ok = false;
+        } else {
+            std::cout << "Packed " << items.size() << " images into " << output << " (" << written << " bytes)"
+                      << std::endl;
+        }
+    }
+
+    for (size_t i = 0; i < items.size(); ++i) {
+        SDL_FreeSurface(items[i].pixels);
+    }
+    IMG_Quit();
+    return ok ? 0 : 1;
+}
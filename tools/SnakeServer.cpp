@@ -0,0 +1,353 @@
+// 本机联机服务器：用 Arena 权威地推进规则，每步给每个客户端发相对其最近确认的 tick 的增量快照
+// 用法：SnakeServer [--port N] [--board WxH] [--players N] [--foods N] [--tick-rate N] [--seed N]
+//                   [--bots N] [--ticks N]
+// 客户端用 Snake --connect [PORT] 加入；--bots N 在本进程里开 N 个同样走 UDP 的机器人客户端，
+// 用于测量每个客户端的带宽和服务器每步的耗时。--tick-rate 0 不限速，--ticks N 跑满 N 步后打印统计并退出
+#include "NetClient.h"
+#include "NetProtocol.h"
+#include "NetSocket.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int DEFAULT_TICK_RATE = 10;
+// 完整快照（每节蛇身 2 位、每个食物约 2 字节）要装进一个 UDP 包，比单机的 MAX_BOARD_SIDE 小得多
+const int MAX_SERVER_BOARD_SIDE = 256;
+const int MAX_PLAYERS = 256;
+const int MAX_FOODS = 4096;
+// 这么久没收到客户端的包就让出它的蛇
+const double CLIENT_TIMEOUT_SECONDS = 5.0;
+// 不限步数运行时打印统计的间隔
+const double STATS_INTERVAL_SECONDS = 10.0;
+
+typedef std::chrono::steady_clock Clock;
+
+class GameServer {
+public:
+    GameServer(int cols, int rows, int players, int foods, unsigned int seed);
+
+    bool open(uint16_t port) { return socket.open(port); }
+    // 收下客户端的包，所有蛇走一步，再给每个客户端发快照
+    void tick();
+    void printStats(int tickRate);
+
+    long long ticks() const { return arena.ticks(); }
+
+private:
+    // 每条蛇对应一个客户端槽位；没有客户端的蛇沿原方向走，死后不再放回
+    struct Slot {
+        bool active;
+        NetAddress address;
+        long long ack;
+        Direction dir;
+        Clock::time_point lastHeard;
+    };
+
+    // 同一步里确认到同一 tick 的客户端共用一份编码
+    struct Encoded {
+        long long base;
+        bool full;
+        std::vector<uint8_t> packet;
+    };
+
+    void receive(Clock::time_point now);
+    int findSlot(const NetAddress& address) const;
+    const Encoded& encodeFor(long long base);
+
+    UdpSocket socket;
+    Arena arena;
+    SnapshotHistory history;
+    std::vector<Slot> slots;
+    std::vector<Direction> actions;
+    std::vector<StepResult> results;
+    std::vector<Encoded> encoded;
+    size_t encodedCount;
+    std::vector<uint8_t> buffer;
+
+    // 统计：服务器每步的耗时（收包、推进、编码与发送）和发出的快照
+    long long measuredTicks;
+    double tickSeconds;
+    double maxTickSeconds;
+    long long snapshotsSent;
+    long long bytesSent;
+    long long fullSnapshots;
+    long long sendFailures;
+};
+
+GameServer::GameServer(int cols, int rows, int players, int foods, unsigned int seed)
+        : arena(cols, rows, players, foods, seed), slots(players), actions(players, RIGHT), results(players),
+          encodedCount(0), buffer(NET_MAX_PACKET), measuredTicks(0), tickSeconds(0), maxTickSeconds(0),
+          snapshotsSent(0), bytesSent(0), fullSnapshots(0), sendFailures(0) {
+    for (Slot& slot : slots) {
+        slot.active = false;
+    }
+    history.start(arena);
+}
+
+int GameServer::findSlot(const NetAddress& address) const {
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i].active && slots[i].address == address) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void GameServer::receive(Clock::time_point now) {
+    NetAddress from;
+    int size;
+    // 空的数据报也要取走，不能让它打断这一步的收包
+    while ((size = socket.receive(buffer.data(), static_cast<int>(buffer.size()), from)) >= 0) {
+        if (size == 0) {
+            continue;
+        }
+        int i = findSlot(from);
+        InputPacket input;
+        if (buffer[0] == PACKET_JOIN && size == 1) {
+            // 重复的申请（回复丢了）照原样再答一次
+            if (i < 0) {
+                for (i = 0; i < static_cast<int>(slots.size()) && slots[i].active; ++i) {
+                }
+                if (i == static_cast<int>(slots.size())) {
+                    continue;  // 已满：不回复，客户端等到超时
+                }
+                slots[i] = {true, from, -1, arena.direction(i), now};
+            }
+            uint8_t packet[16];
+            int length = writeWelcome({i, arena.cols(), arena.rows(), arena.snakeCount()}, packet);
+            socket.send(from, packet, length);
+        } else if (i >= 0 && readInput(buffer.data(), size, input)) {
+            Slot& slot = slots[i];
+            // 确认可能乱序到达，只往前推；客户端局面出错重来时确认回到 -1
+            slot.ack = input.ack < 0 ? -1 : std::max(slot.ack, input.ack);
+            slot.dir = input.dir;
+            slot.lastHeard = now;
+        }
+    }
+}
+
+const GameServer::Encoded& GameServer::encodeFor(long long base) {
+    for (size_t k = 0; k < encodedCount; ++k) {
+        if (encoded[k].base == base) {
+            return encoded[k];
+        }
+    }
+    if (encodedCount == encoded.size()) {
+        encoded.emplace_back();
+    }
+    Encoded& entry = encoded[encodedCount++];
+    entry.base = base;
+    entry.full = history.encode(arena, base, entry.packet);
+    return entry;
+}
+
+void GameServer::tick() {
+    Clock::time_point start = Clock::now();
+    receive(start);
+
+    for (int i = 0; i < arena.snakeCount(); ++i) {
+        Slot& slot = slots[i];
+        if (slot.active && std::chrono::duration<double>(start - slot.lastHeard).count() > CLIENT_TIMEOUT_SECONDS) {
+            slot.active = false;
+        }
+        if (slot.active && !arena.isAlive(i)) {
+            arena.spawn(i);
+        }
+        actions[i] = slot.active ? slot.dir : (arena.isAlive(i) ? arena.direction(i) : RIGHT);
+    }
+    arena.step(actions.data(), results.data());
+    history.record(arena, results.data());
+
+    encodedCount = 0;
+    for (const Slot& slot : slots) {
+        if (!slot.active) continue;
+        const Encoded& entry = encodeFor(slot.ack);
+        if (!socket.send(slot.address, entry.packet.data(), static_cast<int>(entry.packet.size()))) {
+            ++sendFailures;
+            continue;
+        }
+        ++snapshotsSent;
+        bytesSent += static_cast<long long>(entry.packet.size());
+        fullSnapshots += entry.full;
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    tickSeconds += seconds;
+    maxTickSeconds = std::max(maxTickSeconds, seconds);
+    ++measuredTicks;
+}
+
+void GameServer::printStats(int tickRate) {
+    int clients = 0;
+    for (const Slot& slot : slots) clients += slot.active;
+    std::vector<uint8_t> full;
+    history.encode(arena, -1, full);
+
+    std::printf("Tick %lld: %d clients, %d alive, server tick avg %.1f us, max %.1f us\n", arena.ticks(), clients,
+                arena.aliveCount(), measuredTicks > 0 ? tickSeconds * 1e6 / measuredTicks : 0.0,
+                maxTickSeconds * 1e6);
+    if (snapshotsSent > 0) {
+        double perSnapshot = static_cast<double>(bytesSent) / snapshotsSent;
+        std::printf("  %.1f bytes per client per tick (%.2f kbit/s at %d ticks/s), full snapshot now %d bytes, "
+                    "%lld of %lld snapshots sent in full\n",
+                    perSnapshot, perSnapshot * 8 * tickRate / 1000.0, tickRate, static_cast<int>(full.size()),
+                    fullSnapshots, snapshotsSent);
+    }
+    if (sendFailures > 0) {
+        std::printf("  %lld snapshots could not be sent\n", sendFailures);
+    }
+}
+
+// 机器人客户端：与 Snake --connect 走同样的协议，大多直走，偶尔随机转向，避开下一步就会撞上的格子
+class Bot {
+public:
+    explicit Bot(uint64_t seed) : rng(seed) {}
+
+    bool open(uint16_t port) {
+        if (!client.open(port)) return false;
+        client.join();
+        return true;
+    }
+
+    void update() {
+        if (!client.poll()) {
+            if (!client.joined()) client.join();
+            return;
+        }
+        const NetMirror& world = client.mirror();
+        int me = client.snake();
+        Direction d = client.direction();
+        if (world.tick() >= 0 && world.isAlive(me)) {
+            if (rng.bounded(8) == 0 || blocked(world, advance(world.head(me), d))) {
+                Direction turn = static_cast<Direction>(rng.bounded(4));
+                if (turn != opposite(d) && !blocked(world, advance(world.head(me), turn))) {
+                    d = turn;
+                }
+            }
+        }
+        client.sendInput(d);
+    }
+
+    long long bytesReceived() const { return client.bytesReceived(); }
+
+private:
+    static bool blocked(const NetMirror& world, Position p) {
+        return p.x < 0 || p.y < 0 || p.x >= world.cols() || p.y >= world.rows() || world.ownerAt(p) >= 0;
+    }
+
+    NetClient client;
+    Rng rng;
+};
+
+}
+
+int main(int argc, char* argv[]) {
+    int port = NET_DEFAULT_PORT;
+    int cols = 64;
+    int rows = 64;
+    int players = 64;
+    int foods = 64;
+    int tickRate = DEFAULT_TICK_RATE;
+    unsigned int seed = 1;
+    int bots = 0;
+    long long maxTicks = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--board") == 0 && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%dx%d", &cols, &rows) != 2) {
+                cols = -1;
+            }
+        } else if (std::strcmp(argv[i], "--players") == 0 && i + 1 < argc) {
+            players = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--foods") == 0 && i + 1 < argc) {
+            foods = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            tickRate = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--bots") == 0 && i + 1 < argc) {
+            bots = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            maxTicks = std::atoll(argv[++i]);
+        } else {
+            std::cerr << "Usage: SnakeServer [--port N] [--board WxH] [--players N] [--foods N] [--tick-rate N] "
+                         "[--seed N] [--bots N] [--ticks N]"
+                      << std::endl;
+            return 2;
+        }
+    }
+    // 下限与单机相同，否则客户端（Snake --connect）加入时会拒绝这块棋盘
+    if (!validBoardSize(cols, rows) || cols > MAX_SERVER_BOARD_SIDE || rows > MAX_SERVER_BOARD_SIDE) {
+        std::cerr << "Invalid board size, expected WxH with " << MIN_BOARD_COLS << " <= W <= " << MAX_SERVER_BOARD_SIDE
+                  << " and " << MIN_BOARD_ROWS << " <= H <= " << MAX_SERVER_BOARD_SIDE << std::endl;
+        return 2;
+    }
+    if (port <= 0 || port > 65535 || players < 1 || players > MAX_PLAYERS || foods < 0 || foods > MAX_FOODS ||
+        tickRate < 0 || bots < 0 || bots > players || maxTicks < 0) {
+        std::cerr << "Invalid option: need 1 <= players <= " << MAX_PLAYERS << ", 0 <= foods <= " << MAX_FOODS
+                  << ", bots <= players" << std::endl;
+        return 2;
+    }
+
+    GameServer server(cols, rows, players, foods, seed);
+    if (!server.open(static_cast<uint16_t>(port))) {
+        return 1;
+    }
+    std::vector<std::unique_ptr<Bot>> botClients;
+    for (int i = 0; i < bots; ++i) {
+        botClients.emplace_back(new Bot(seed + 1 + i));
+        if (!botClients.back()->open(static_cast<uint16_t>(port))) {
+            return 1;
+        }
+    }
+    std::cout << "Serving " << cols << "x" << rows << " for " << players << " players on 127.0.0.1:" << port
+              << (tickRate > 0 ? "" : ", uncapped") << std::endl;
+
+    const int reportRate = tickRate > 0 ? tickRate : DEFAULT_TICK_RATE;
+    const Clock::duration tickLength =
+            tickRate > 0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / tickRate))
+                         : Clock::duration::zero();
+    Clock::time_point nextTick = Clock::now();
+    Clock::time_point nextStats = nextTick + std::chrono::duration_cast<Clock::duration>(
+                                                     std::chrono::duration<double>(STATS_INTERVAL_SECONDS));
+    while (maxTicks == 0 || server.ticks() < maxTicks) {
+        server.tick();
+        // 回环上发出的包立刻就能收到，机器人在同一轮里回复，服务器下一步开头收下
+        for (auto& bot : botClients) {
+            bot->update();
+        }
+
+        Clock::time_point now = Clock::now();
+        if (maxTicks == 0 && now >= nextStats) {
+            server.printStats(reportRate);
+            nextStats = now + std::chrono::duration_cast<Clock::duration>(
+                                      std::chrono::duration<double>(STATS_INTERVAL_SECONDS));
+        }
+        if (tickRate > 0) {
+            // 落后太多时不再追赶
+            nextTick += tickLength;
+            if (nextTick < now) {
+                nextTick = now;
+            }
+            std::this_thread::sleep_until(nextTick);
+        }
+    }
+
+    server.printStats(reportRate);
+    if (!botClients.empty()) {
+        long long received = 0;
+        for (auto& bot : botClients) received += bot->bytesReceived();
+        std::printf("  bots received %.1f bytes per client per tick\n",
+                    static_cast<double>(received) / botClients.size() / server.ticks());
+    }
+    return 0;
+}